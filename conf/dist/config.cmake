@@ -11,6 +11,7 @@
 #
 
 option(BUILD_TESTING       "Build unit tests"                                            1)
+option(TOOL_DBBENCH        "Build the database benchmark tool"                           0)
 option(WITH_WARNINGS       "Show all warnings during compile"                            0)
 option(WITH_DYNAMIC_LINKING "Enable dynamic library linking."                            0)
 
@@ -25,6 +25,7 @@
 #include "DiscordMgr.h"
 #include "DatabaseMgr.h"
 #include "DatabaseEnv.h"
+#include "StopWatch.h"
 #include "ThreadPool.h"
 #include <boost/version.hpp>
 #include <filesystem>
@@ -34,6 +35,7 @@
 
 namespace fs = std::filesystem;
 constexpr auto WARHEAD_SERVER_CONFIG = "DiscordBot.conf";
+constexpr auto SERVER_IDLE_UPDATE_INTERVAL = 50ms;
 
 bool StartDB();
 void ServerUpdateLoop();
@@ -70,10 +72,18 @@ int main()
     LOG_INFO("core", "> Using DB client version:        {}", sDatabaseMgr->GetClientInfo());
     LOG_INFO("core", "> Using DB server version:        {}", sDatabaseMgr->GetServerVersion());
 
+    StopWatch startup;
+
+    // Gateway handshake doesn't need the database, it runs while the databases are loaded
+    sDiscordMgr->Connect();
+    Microseconds const connectTime = startup.Elapsed();
+
     // Initialize the database connection
     if (!StartDB())
         return 1;
 
+    Microseconds const databaseTime = startup.Elapsed();
+
     std::shared_ptr<void> dbHandle(nullptr, [](void*) { sDatabaseMgr->CloseAllConnections(); });
 
     auto threadPool = std::make_unique<Warhead::ThreadPool>(1);
@@ -85,6 +95,13 @@ int main()
     // Start discord
     sDiscordMgr->Start();
 
+    Microseconds const readyTime = startup.Elapsed();
+
+    LOG_INFO("server.loading", ">> Startup timeline: discord connect {}, databases {}, discord start {}. Ready in {}",
+        Warhead::Time::ToTimeString(connectTime), Warhead::Time::ToTimeString(databaseTime - connectTime),
+        Warhead::Time::ToTimeString(readyTime - databaseTime), Warhead::Time::ToTimeString(readyTime));
+    LOG_INFO("server.loading", "");
+
     ServerUpdateLoop();
 
     LOG_INFO("server", "Halting process...");
@@ -114,14 +131,11 @@ void ServerUpdateLoop()
         realCurrTime = GetTimeMS();
 
         auto diff = GetMSTimeDiff(realPrevTime, realCurrTime);
-        if (diff == 0ms)
-        {
-            // sleep until enough time passes that we can update all timers
-            std::this_thread::sleep_for(1ms);
-            continue;
-        }
 
         sBotMgr->Update(diff);
         realPrevTime = realCurrTime;
+
+        // Completed async queries wake the loop, timers are updated at least once per interval
+        sBotMgr->WaitForWork(SERVER_IDLE_UPDATE_INTERVAL);
     }
 }
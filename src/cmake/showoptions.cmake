@@ -41,6 +41,12 @@ else()
   message(STATUS "* Build unit tests                : No  (default)")
 endif()
 
+if (TOOL_DBBENCH)
+  message(STATUS "* Build database benchmark tool   : Yes")
+else()
+  message(STATUS "* Build database benchmark tool   : No  (default)")
+endif()
+
 if (WITH_WARNINGS)
   message(STATUS "* Show all warnings               : Yes")
 else()
@@ -34,9 +34,6 @@ namespace BuiltInConfig
     /// Returns the source directory path when any is specified in the config,
     /// returns the built-in one otherwise
     WH_COMMON_API std::string GetSourceDirectory();
-    /// Returns the path to the mysql executable (`mysql`) when any is specified
-    /// in the config, returns the built-in one otherwise
-    WH_COMMON_API std::string GetMySQLExecutable();
 
 } // namespace BuiltInConfig
 
@@ -21,6 +21,16 @@
 #include "FileUtil.h"
 #include <algorithm>
 #include <filesystem>
+#include <utility>
+
+#if WARHEAD_PLATFORM == WARHEAD_PLATFORM_WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace fs = std::filesystem;
 
@@ -54,3 +64,108 @@ bool Warhead::File::CreateDirIfNeed(std::string_view path)
         return false;
     }
 }
+
+Warhead::File::MappedFile::MappedFile(MappedFile&& right) noexcept :
+    _data(std::exchange(right._data, nullptr)), _size(std::exchange(right._size, 0)), _isOpen(std::exchange(right._isOpen, false)) { }
+
+Warhead::File::MappedFile& Warhead::File::MappedFile::operator=(MappedFile&& right) noexcept
+{
+    if (this != &right)
+    {
+        Close();
+        _data = std::exchange(right._data, nullptr);
+        _size = std::exchange(right._size, 0);
+        _isOpen = std::exchange(right._isOpen, false);
+    }
+
+    return *this;
+}
+
+bool Warhead::File::MappedFile::Open(std::filesystem::path const& path)
+{
+    Close();
+
+#if WARHEAD_PLATFORM == WARHEAD_PLATFORM_WINDOWS
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // Empty file can't be mapped
+    if (size.QuadPart)
+    {
+        // View keeps the mapping alive, handles can be closed at once
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+        if (mapping)
+            CloseHandle(mapping);
+
+        if (!data)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        _data = static_cast<char const*>(data);
+        _size = static_cast<std::size_t>(size.QuadPart);
+    }
+
+    CloseHandle(file);
+#else
+    int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+        return false;
+
+    struct stat info{};
+    if (::fstat(file, &info))
+    {
+        ::close(file);
+        return false;
+    }
+
+    // Empty file can't be mapped
+    if (info.st_size)
+    {
+        void* data = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(file);
+            return false;
+        }
+
+        ::madvise(data, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+
+        _data = static_cast<char const*>(data);
+        _size = static_cast<std::size_t>(info.st_size);
+    }
+
+    // Mapping stays valid after the descriptor is closed
+    ::close(file);
+#endif
+
+    _isOpen = true;
+    return true;
+}
+
+void Warhead::File::MappedFile::Close()
+{
+    if (_data)
+    {
+#if WARHEAD_PLATFORM == WARHEAD_PLATFORM_WINDOWS
+        UnmapViewOfFile(_data);
+#else
+        ::munmap(const_cast<char*>(_data), _size);
+#endif
+    }
+
+    _data = nullptr;
+    _size = 0;
+    _isOpen = false;
+}
@@ -19,12 +19,40 @@
 #define _WARHEAD_FILE_UTIL_H_
 
 #include "Define.h"
+#include <filesystem>
 #include <string_view>
 
 namespace Warhead::File
 {
     WH_COMMON_API void CorrectDirPath(std::string& path);
     WH_COMMON_API bool CreateDirIfNeed(std::string_view path);
+
+    //! Read only view of a whole file mapped into memory, pages are read by the OS on first access
+    class WH_COMMON_API MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { Close(); }
+
+        MappedFile(MappedFile&& right) noexcept;
+        MappedFile& operator=(MappedFile&& right) noexcept;
+
+        bool Open(std::filesystem::path const& path);
+        void Close();
+
+        [[nodiscard]] inline bool IsOpen() const { return _isOpen; }
+
+        //! Empty for an empty file, valid until the file is closed
+        [[nodiscard]] inline std::string_view GetView() const { return { _data, _size }; }
+
+    private:
+        char const* _data{ nullptr };
+        std::size_t _size{};
+        bool _isOpen{};
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+    };
 }
 
 #endif // _WARHEAD_FILE_UTIL_H_
@@ -0,0 +1,150 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WARHEAD_INPLACE_FUNCTION_H
+#define WARHEAD_INPLACE_FUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Warhead
+{
+    template<typename Signature, std::size_t Size>
+    class InplaceFunction;
+
+    //! Move only std::function replacement, callables up to Size bytes are stored inline and only bigger ones are allocated
+    template<typename R, typename... Args, std::size_t Size>
+    class InplaceFunction<R(Args...), Size>
+    {
+        static_assert(Size >= sizeof(void*), "Buffer must be able to hold a pointer to an allocated callable");
+
+    public:
+        InplaceFunction() = default;
+
+        template<typename F> requires (!std::is_same_v<std::decay_t<F>, InplaceFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+        InplaceFunction(F&& function)
+        {
+            using Callable = std::decay_t<F>;
+
+            if constexpr (IsInline<Callable>)
+                new (_buffer) Callable(std::forward<F>(function));
+            else
+                new (_buffer) Callable*(new Callable(std::forward<F>(function)));
+
+            _operations = &OperationsFor<Callable>;
+        }
+
+        InplaceFunction(InplaceFunction&& right) noexcept
+        {
+            MoveFrom(std::move(right));
+        }
+
+        InplaceFunction& operator=(InplaceFunction&& right) noexcept
+        {
+            if (this != &right)
+            {
+                Reset();
+                MoveFrom(std::move(right));
+            }
+
+            return *this;
+        }
+
+        ~InplaceFunction() { Reset(); }
+
+        R operator()(Args... args)
+        {
+            return _operations->Invoke(_buffer, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const { return _operations != nullptr; }
+
+        void Reset()
+        {
+            if (!_operations)
+                return;
+
+            _operations->Destroy(_buffer);
+            _operations = nullptr;
+        }
+
+    private:
+        struct Operations
+        {
+            R(*Invoke)(void* storage, Args&&... args);
+            void(*Move)(void* to, void* from);
+            void(*Destroy)(void* storage);
+        };
+
+        template<typename Callable>
+        static constexpr bool IsInline = sizeof(Callable) <= Size && alignof(Callable) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Callable>;
+
+        template<typename Callable>
+        static Callable& Get(void* storage)
+        {
+            if constexpr (IsInline<Callable>)
+                return *std::launder(reinterpret_cast<Callable*>(storage));
+            else
+                return **std::launder(reinterpret_cast<Callable**>(storage));
+        }
+
+        template<typename Callable>
+        static constexpr Operations OperationsFor
+        {
+            [](void* storage, Args&&... args) -> R
+            {
+                return Get<Callable>(storage)(std::forward<Args>(args)...);
+            },
+            [](void* to, void* from)
+            {
+                if constexpr (IsInline<Callable>)
+                {
+                    new (to) Callable(std::move(Get<Callable>(from)));
+                    Get<Callable>(from).~Callable();
+                }
+                else
+                    new (to) Callable*(*std::launder(reinterpret_cast<Callable**>(from)));
+            },
+            [](void* storage)
+            {
+                if constexpr (IsInline<Callable>)
+                    Get<Callable>(storage).~Callable();
+                else
+                    delete &Get<Callable>(storage);
+            }
+        };
+
+        void MoveFrom(InplaceFunction&& right)
+        {
+            if (!right._operations)
+                return;
+
+            right._operations->Move(_buffer, right._buffer);
+            _operations = std::exchange(right._operations, nullptr);
+        }
+
+        alignas(std::max_align_t) std::byte _buffer[Size];
+        Operations const* _operations{ nullptr };
+
+        InplaceFunction(InplaceFunction const&) = delete;
+        InplaceFunction& operator=(InplaceFunction const&) = delete;
+    };
+}
+
+#endif // WARHEAD_INPLACE_FUNCTION_H
@@ -33,12 +33,20 @@ void BotMgr::StopNow()
 {
     _stopEvent = true;
     sIoContextMgr->Stop();
+    sBotMgr->_queryProcessor.Wake();
 }
 
 void BotMgr::Update(Milliseconds diff)
 {
     ProcessQueryCallbacks();
-    sDatabaseMgr->Update(diff);
+
+    if (diff > 0ms)
+        sDatabaseMgr->Update(diff);
+}
+
+void BotMgr::WaitForWork(Milliseconds timeout)
+{
+    _queryProcessor.WaitForCompletion(timeout);
 }
 
 void BotMgr::ProcessQueryCallbacks()
@@ -18,10 +18,9 @@
 #ifndef _WARHEAD_BOT_MGR_H_
 #define _WARHEAD_BOT_MGR_H_
 
-#include "AsyncCallbackProcessor.h"
 #include "Define.h"
 #include "Duration.h"
-#include "DatabaseEnvFwd.h"
+#include "QueryCallbackProcessor.h"
 #include <atomic>
 #include <mutex>
 
@@ -36,6 +35,9 @@ public:
     void Initialize();
     void Update(Milliseconds diff);
 
+    //! Sleeps until an async query completes, the bot is stopped or the timeout passes
+    void WaitForWork(Milliseconds timeout);
+
     static bool IsStopped() { return _stopEvent; }
     static void StopNow();
 
@@ -21,6 +21,22 @@
 #include "Containers.h"
 #include "StopWatch.h"
 
+namespace
+{
+    // SELECT `guild_id`, `enable_role_check`, `enable_role_add`, `role_id_user`, `role_id_friend` FROM `guild_config`
+    struct GuildConfigRow
+    {
+        uint64 GuildId{};
+        bool EnableRoleCheck{};
+        bool EnableRoleAdd{};
+        uint64 RoleIdUser{};
+        uint64 RoleIdFriend{};
+    };
+
+    using GuildConfigSchema = RowSchema<&GuildConfigRow::GuildId, &GuildConfigRow::EnableRoleCheck, &GuildConfigRow::EnableRoleAdd,
+        &GuildConfigRow::RoleIdUser, &GuildConfigRow::RoleIdFriend>;
+}
+
 DiscordConfigMgr* DiscordConfigMgr::instance()
 {
     static DiscordConfigMgr instance;
@@ -38,22 +54,28 @@ void DiscordConfigMgr::LoadConfig()
         return;
     }
 
-    for (auto const& row : *result)
+    std::vector<GuildConfigRow> rows;
+    if (!result->FetchRows<GuildConfigSchema>(rows))
+    {
+        LOG_ERROR("sql", "Guild config: Table `guild_config` does not match the expected schema");
+        return;
+    }
+
+    for (auto const& row : rows)
     {
-        auto guildId = row[0].Get<uint64>();
-        if (GetConfig(guildId))
+        if (GetConfig(row.GuildId))
         {
-            LOG_ERROR("sql", "Guid config: Exit guild id: {}", guildId);
+            LOG_ERROR("sql", "Guid config: Exit guild id: {}", row.GuildId);
             continue;
         }
 
         DiscordGuildConfig config{};
-        config.EnableRoleCheck  = row[1].Get<bool>();
-        config.EnableRoleAdd    = row[2].Get<bool>();
-        config.RoleIdUser       = row[3].Get<uint64>();
-        config.RoleIdFriend     = row[4].Get<uint64>();
+        config.EnableRoleCheck  = row.EnableRoleCheck;
+        config.EnableRoleAdd    = row.EnableRoleAdd;
+        config.RoleIdUser       = row.RoleIdUser;
+        config.RoleIdFriend     = row.RoleIdFriend;
 
-        _guildConfigs.emplace(guildId, config);
+        _guildConfigs.emplace(row.GuildId, config);
     }
 
     LOG_INFO("loading", "Loaded {} guild config in {}", _guildConfigs.size(), sw);
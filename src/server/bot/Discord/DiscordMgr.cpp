@@ -36,6 +36,59 @@ namespace
     // Owner
     constexpr auto OWNER_ID = 365169287926906883; // Winfidonarleyan | <@365169287926906883>
     constexpr auto OWNER_MENTION = "<@365169287926906883>";
+
+    // Discord drops interactions which aren't answered in 3 seconds, keep some time for the reply itself
+    constexpr auto INTERACTION_REPLY_TIMEOUT = 2500ms;
+
+    // Deferred reply can be edited for 15 minutes, a started query is interrupted by the server at its deadline anyway
+    constexpr auto INTERACTION_DEFERRED_REPLY_TIMEOUT = 10s;
+
+    // SELECT `nickname`, `ilvl`, `game_spec`, `twinks` FROM `guild_players` WHERE `discord_guild_id` = ?
+    struct GuildPlayerRow
+    {
+        std::string Nickname;
+        int32 Ilvl{};
+        std::string GameSpec;
+        std::string Twinks;
+    };
+
+    using GuildPlayerSchema = RowSchema<&GuildPlayerRow::Nickname, &GuildPlayerRow::Ilvl, &GuildPlayerRow::GameSpec, &GuildPlayerRow::Twinks>;
+
+    // Replies with the message filled by the query callback, once done is set
+    void ReplyWhenQueryDone(dpp::slashcommand_t const& event, std::future<void> done, AsyncCompletionPtr const& completion, std::shared_ptr<DiscordEmbedMsg> const& replyMsg)
+    {
+        auto const channelId = uint64(event.command.channel_id);
+        bool deferred{};
+
+        if (done.wait_for(INTERACTION_REPLY_TIMEOUT) == std::future_status::timeout)
+        {
+            // Interaction can't be answered anymore, the query isn't executed
+            if (completion->Cancel())
+            {
+                LOG_WARN("discord", "> Database didn't answer in {} ms, interaction of channel {} is not answered", INTERACTION_REPLY_TIMEOUT.count(), channelId);
+                return;
+            }
+
+            // Worker already executes the query and its callback is invoked, the user sees it's still processed until the result is there
+            event.thinking(true);
+            deferred = true;
+
+            if (done.wait_for(INTERACTION_DEFERRED_REPLY_TIMEOUT) == std::future_status::timeout)
+            {
+                LOG_WARN("discord", "> Database didn't answer in {} s, deferred interaction of channel {} is not answered", INTERACTION_DEFERRED_REPLY_TIMEOUT.count(), channelId);
+                event.edit_original_response(dpp::message{ event.command.channel_id, "Запрос всё ещё выполняется, попробуйте позже" });
+                return;
+            }
+        }
+
+        dpp::message replyMessage{ event.command.channel_id, *replyMsg->GetMessage() };
+        replyMessage.set_flags(dpp::m_ephemeral);
+
+        if (deferred)
+            event.edit_original_response(replyMessage);
+        else
+            event.reply(replyMessage);
+    }
 }
 
 DiscordMgr* DiscordMgr::instance()
@@ -50,6 +103,11 @@ DiscordMgr::~DiscordMgr()
 }
 
 void DiscordMgr::LoadConfig(bool /*reload*/)
+{
+    sDiscordConfigMgr->LoadConfig();
+}
+
+void DiscordMgr::Connect()
 {
     _botToken = sConfigMgr->GetOption<std::string>("Discord.Bot.Token", "");
     if (_botToken.empty())
@@ -59,21 +117,22 @@ void DiscordMgr::LoadConfig(bool /*reload*/)
         return;
     }
 
-    sDiscordConfigMgr->LoadConfig();
-}
-
-void DiscordMgr::Start()
-{
-    LOG_INFO("server.loading", "Loading discord bot...");
-
-    StopWatch sw;
+    LOG_INFO("server.loading", "Connecting discord bot...");
 
     _bot = std::make_unique<dpp::cluster>(_botToken, dpp::i_unverified_default_intents);
 
     // Prepare logs
     ConfigureLogs();
 
+    // Gateway handshake runs on the threads of the cluster
     _bot->start(dpp::st_return);
+}
+
+void DiscordMgr::Start()
+{
+    LOG_INFO("server.loading", "Loading discord bot...");
+
+    StopWatch sw;
 
     // Check bot in guild, category and text channels
     CheckGuild();
@@ -400,10 +459,10 @@ void DiscordMgr::AddGuildNickName(uint64 guildId, uint64 userId, uint64 channelI
     std::string saveNickName{ nickName };
     NormalizePlayerName(saveNickName);
 
-    auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_SEL_NICKNAME);
+    auto stmt = DiscordDatabase.GetPreparedStatement<DiscordSelNicknameStmt>();
     stmt->SetArguments(guildId, saveNickName);
 
-    sBotMgr->GetQueryProcessor().AddCallback(DiscordDatabase.AsyncQuery(stmt)).WithPreparedCallback([this, guildId, userId, channelId, saveNickName, gameSpec = std::string(gameSpec), ilvl](PreparedQueryResult result)
+    sBotMgr->GetQueryProcessor().AddCallback(DiscordDatabase.AsyncQuery(stmt).WithPreparedCallback([this, guildId, userId, channelId, saveNickName, gameSpec = std::string(gameSpec), ilvl](PreparedQueryResult result)
     {
         auto embedMsg = std::make_shared<DiscordEmbedMsg>();
         embedMsg->SetTitle("Вступление в гильдию");
@@ -418,7 +477,7 @@ void DiscordMgr::AddGuildNickName(uint64 guildId, uint64 userId, uint64 channelI
         }
 
         // INSERT INTO `guild_players` (`discord_guild_id`, `user_id`, `nickname`, `ilvl`, `game_spec`) VALUES (?, ?, ?, ?, ?)
-        auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_INS_NICKNAME);
+        auto stmt = DiscordDatabase.GetPreparedStatement<DiscordInsNicknameStmt>();
         stmt->SetArguments(guildId, userId, saveNickName, ilvl, gameSpec);
         DiscordDatabase.Execute(stmt);
 
@@ -456,7 +515,7 @@ void DiscordMgr::AddGuildNickName(uint64 guildId, uint64 userId, uint64 channelI
         }
 
         SendEmbedMessage(*embedMsg, channelId);
-    });
+    }));
 }
 
 void DiscordMgr::GuildAddHandler(const dpp::slashcommand_t &event)
@@ -613,10 +672,10 @@ void DiscordMgr::GuildGetPlayersHandler(const dpp::slashcommand_t &event)
 
     auto waiter = std::make_shared<std::promise<void>>();
     auto channelId = event.command.channel_id;
-    auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_SEL_NICKNAMES);
+    auto stmt = DiscordDatabase.GetPreparedStatement<DiscordSelNicknamesStmt>();
     stmt->SetArguments(uint64(event.command.guild_id));
 
-    sBotMgr->GetQueryProcessor().AddCallback(DiscordDatabase.AsyncQuery(stmt)).WithPreparedCallback([this, waiter, replyMsg, channelId](PreparedQueryResult result)
+    auto query = DiscordDatabase.AsyncQuery(stmt, INTERACTION_REPLY_TIMEOUT).WithPreparedCallback([this, waiter, replyMsg, channelId](PreparedQueryResult result)
     {
         if (!result)
         {
@@ -626,20 +685,28 @@ void DiscordMgr::GuildGetPlayersHandler(const dpp::slashcommand_t &event)
             waiter->set_value();
             return;
         }
-        else
+
+        auto players = result->FetchRows<GuildPlayerSchema>();
+        if (!players)
         {
-            replyMsg->SetColor(DiscordMessageColor::Cyan);
-            replyMsg->AddEmbedField("Количество участников", Warhead::StringFormat("{}", result->GetRowCount()));
+            replyMsg->SetColor(DiscordMessageColor::Red);
+            replyMsg->SetDescription("Не удалось прочитать участников гильдии");
 
             waiter->set_value();
+            return;
         }
 
+        replyMsg->SetColor(DiscordMessageColor::Cyan);
+        replyMsg->AddEmbedField("Количество участников", Warhead::StringFormat("{}", players->size()));
+
+        waiter->set_value();
+
         auto msg = std::make_shared<DiscordEmbedMsg>();
         msg->SetTitle("Участники гильдии");
         msg->SetColor(DiscordMessageColor::Indigo);
         uint8 count{};
 
-        for (auto& row : *result)
+        for (auto const& player : *players)
         {
             if (++count >= 23)
             {
@@ -650,22 +717,16 @@ void DiscordMgr::GuildGetPlayersHandler(const dpp::slashcommand_t &event)
                 msg->SetColor(DiscordMessageColor::Indigo);
             }
 
-            // SELECT `nickname`, `ilvl`, `game_spec`, `twinks` FROM `guild_players` WHERE `discord_guild_id` = ?
-            auto nickName = row[0].Get<std::string_view>();
-            auto ilvl = row[1].Get<int32>();
-            auto gameSpec = row[2].Get<std::string_view>();
-
-            msg->AddEmbedField(nickName, Warhead::StringFormat("Спек: `{}`. Илвл: `{}`", gameSpec, ilvl));
+            msg->AddEmbedField(player.Nickname, Warhead::StringFormat("Спек: `{}`. Илвл: `{}`", player.GameSpec, player.Ilvl));
         }
 
         SendEmbedMessage(*msg, channelId);
     });
 
-    waiter->get_future().wait();
+    auto completion = query.GetCompletion();
+    sBotMgr->GetQueryProcessor().AddCallback(std::move(query));
 
-    dpp::message replyMessage{ channelId, *replyMsg->GetMessage() };
-    replyMessage.set_flags(dpp::m_ephemeral);
-    event.reply(replyMessage);
+    ReplyWhenQueryDone(event, waiter->get_future(), completion, replyMsg);
 }
 
 void DiscordMgr::GuildDelHandler(const dpp::slashcommand_t &event)
@@ -680,10 +741,10 @@ void DiscordMgr::GuildDelHandler(const dpp::slashcommand_t &event)
     auto waiter = std::make_shared<std::promise<void>>();
     auto channelId = event.command.channel_id;
     auto guildId = event.command.guild_id;
-    auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_SEL_NICKNAMES);
+    auto stmt = DiscordDatabase.GetPreparedStatement<DiscordSelNicknamesStmt>();
     stmt->SetArguments(uint64(event.command.guild_id));
 
-    sBotMgr->GetQueryProcessor().AddCallback(DiscordDatabase.AsyncQuery(stmt)).WithPreparedCallback([this, waiter, replyMsg, guildId, channelId, targetNickname](PreparedQueryResult result)
+    auto query = DiscordDatabase.AsyncQuery(stmt, INTERACTION_REPLY_TIMEOUT).WithPreparedCallback([this, waiter, replyMsg, guildId, channelId, targetNickname](PreparedQueryResult result)
     {
         if (!result)
         {
@@ -694,24 +755,29 @@ void DiscordMgr::GuildDelHandler(const dpp::slashcommand_t &event)
             return;
         }
 
+        auto players = result->FetchRows<GuildPlayerSchema>();
+        if (!players)
+        {
+            replyMsg->SetColor(DiscordMessageColor::Red);
+            replyMsg->SetDescription("Не удалось прочитать участников гильдии");
+
+            waiter->set_value();
+            return;
+        }
+
         bool found{};
 
-        for (auto& row : *result)
+        for (auto const& player : *players)
         {
-            // SELECT `nickname`, `ilvl`, `game_spec`, `twinks` FROM `guild_players` WHERE `discord_guild_id` = ?
-            auto nickName = row[0].Get<std::string_view>();
-            auto ilvl = row[1].Get<int32>();
-            auto gameSpec = row[2].Get<std::string_view>();
-
-            if (StringEqualI(nickName, targetNickname))
+            if (StringEqualI(player.Nickname, targetNickname))
             {
                 found = true;
                 replyMsg->SetColor(DiscordMessageColor::Yellow);
                 replyMsg->SetDescription("Игрок удалён из базы");
-                replyMsg->AddEmbedField(nickName, Warhead::StringFormat("Спек: `{}`. Илвл: `{}`", gameSpec, ilvl));
+                replyMsg->AddEmbedField(player.Nickname, Warhead::StringFormat("Спек: `{}`. Илвл: `{}`", player.GameSpec, player.Ilvl));
 
-                auto stmt = DiscordDatabase.GetPreparedStatement(DISCORD_DEL_NICKNAME);
-                stmt->SetArguments(uint64(guildId), nickName);
+                auto stmt = DiscordDatabase.GetPreparedStatement<DiscordDelNicknameStmt>();
+                stmt->SetArguments(uint64(guildId), player.Nickname);
 
                 DiscordDatabase.Execute(stmt);
                 break;
@@ -727,9 +793,8 @@ void DiscordMgr::GuildDelHandler(const dpp::slashcommand_t &event)
         waiter->set_value();
     });
 
-    waiter->get_future().wait();
+    auto completion = query.GetCompletion();
+    sBotMgr->GetQueryProcessor().AddCallback(std::move(query));
 
-    dpp::message replyMessage{ channelId, *replyMsg->GetMessage() };
-    replyMessage.set_flags(dpp::m_ephemeral);
-    event.reply(replyMessage);
+    ReplyWhenQueryDone(event, waiter->get_future(), completion, replyMsg);
 }
@@ -48,7 +48,13 @@ public:
 
     static DiscordMgr* instance();
 
+    //! Guild configs are loaded from the database
     void LoadConfig(bool reload);
+
+    //! Starts the gateway connection, it doesn't need the database and can run while the databases are loaded
+    void Connect();
+
+    //! Commands are registered once the databases are loaded, Connect must be called before
     void Start();
     void Stop();
     static bool NormalizePlayerName(std::string& name);
@@ -0,0 +1,122 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "AsyncCompletion.h"
+#include "QueryCallbackProcessor.h"
+#include <mutex>
+
+namespace
+{
+    // Slots above this count are freed instead of kept for reuse
+    constexpr std::size_t MAX_FREE_COMPLETIONS = 1024;
+
+    // Constant initialized, slots can be released by other static destructors during shutdown
+    struct CompletionFreeList
+    {
+        std::mutex Lock;
+        AsyncCompletion* Head{ nullptr };
+        std::size_t Size{};
+    };
+
+    constinit CompletionFreeList FreeList;
+}
+
+AsyncCompletionPtr AsyncCompletion::Create(bool isPrepared)
+{
+    AsyncCompletion* completion{ nullptr };
+
+    {
+        std::lock_guard guard(FreeList.Lock);
+        if (FreeList.Head)
+        {
+            completion = std::exchange(FreeList.Head, FreeList.Head->_nextFree);
+            --FreeList.Size;
+        }
+    }
+
+    if (!completion)
+        completion = new AsyncCompletion();
+
+    completion->_isPrepared = isPrepared;
+    return AsyncCompletionPtr(completion);
+}
+
+void AsyncCompletion::Complete()
+{
+    // Exactly one of Complete and Subscribe sees the other one done and pushes
+    if (_state.fetch_or(STATE_COMPLETED, std::memory_order_acq_rel) & STATE_SUBSCRIBED)
+        Push();
+}
+
+bool AsyncCompletion::Cancel()
+{
+    uint8 state = _state.load(std::memory_order_acquire);
+
+    do
+    {
+        if (state & STATE_CANCELLED)
+            return true;
+
+        if (state & STATE_STARTED)
+            return false;
+    } while (!_state.compare_exchange_weak(state, state | STATE_CANCELLED, std::memory_order_acq_rel, std::memory_order_acquire));
+
+    return true;
+}
+
+void AsyncCompletion::Subscribe(AsyncCompletionQueue* queue, uint32 callbackSlot)
+{
+    _queue = queue;
+    _callbackSlot = callbackSlot;
+
+    if (_state.fetch_or(STATE_SUBSCRIBED, std::memory_order_acq_rel) & STATE_COMPLETED)
+        Push();
+}
+
+void AsyncCompletion::Push()
+{
+    // The queue holds a reference until the slot is popped
+    AddRef();
+    _queue->Push(this);
+}
+
+void AsyncCompletion::Release()
+{
+    if (_refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    _result.reset();
+    _preparedResult.reset();
+    _state.store(0, std::memory_order_relaxed);
+    _queue = nullptr;
+    _callbackSlot = 0;
+
+    {
+        std::lock_guard guard(FreeList.Lock);
+        if (FreeList.Size < MAX_FREE_COMPLETIONS)
+        {
+            _nextFree = std::exchange(FreeList.Head, this);
+            ++FreeList.Size;
+            return;
+        }
+    }
+
+    delete this;
+}
@@ -0,0 +1,150 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ASYNC_COMPLETION_H
+#define _ASYNC_COMPLETION_H
+
+#include "DatabaseEnvFwd.h"
+#include <atomic>
+#include <utility>
+
+class AsyncCompletionQueue;
+
+/**
+    Result slot of an async query, shared by the task executing it, its QueryCallback and the completion queue.
+
+    Slots are reference counted and recycled through a free list when the last reference is gone,
+    so an async query doesn't allocate its completion state (std::promise shared state) in steady state.
+    When the worker is done it pushes the slot to the queue of the processor the callback was added to.
+*/
+class WH_DATABASE_API AsyncCompletion
+{
+    friend class AsyncCompletionPtr;
+
+public:
+    //! Public for the intrusive queue only, slots are released through AsyncCompletionPtr
+    ~AsyncCompletion() = default;
+
+    static AsyncCompletionPtr Create(bool isPrepared);
+
+    //! Called by the worker after the result is set
+    void Complete();
+
+    //! Called by the processor, slot is queued at once if the query is already done
+    void Subscribe(AsyncCompletionQueue* queue, uint32 callbackSlot);
+
+    [[nodiscard]] inline bool IsCompleted() const { return (_state.load(std::memory_order_acquire) & STATE_COMPLETED) != 0; }
+
+    //! Nobody reads the result anymore, the query isn't executed if it's still queued and its callback isn't invoked.
+    //! Returns false if the worker already started the query, its callback is invoked with the result.
+    bool Cancel();
+
+    //! Called by the worker before the query is executed, returns false if it's cancelled
+    inline bool TryStart() { return !(_state.fetch_or(STATE_STARTED, std::memory_order_acq_rel) & STATE_CANCELLED); }
+
+    [[nodiscard]] inline bool IsCancelled() const { return (_state.load(std::memory_order_acquire) & STATE_CANCELLED) != 0; }
+    [[nodiscard]] inline bool IsPrepared() const { return _isPrepared; }
+    [[nodiscard]] inline uint32 GetCallbackSlot() const { return _callbackSlot; }
+
+    inline void SetResult(QueryResult result) { _result = std::move(result); }
+    inline void SetResult(PreparedQueryResult result) { _preparedResult = std::move(result); }
+
+    [[nodiscard]] inline QueryResult TakeResult() { return std::move(_result); }
+    [[nodiscard]] inline PreparedQueryResult TakePreparedResult() { return std::move(_preparedResult); }
+
+    std::atomic<AsyncCompletion*> QueueLink{ nullptr };
+
+private:
+    enum State : uint8
+    {
+        STATE_COMPLETED  = 0x1,
+        STATE_SUBSCRIBED = 0x2,
+        STATE_CANCELLED  = 0x4,
+        STATE_STARTED    = 0x8
+    };
+
+    AsyncCompletion() = default;
+
+    inline void AddRef() { _refCount.fetch_add(1, std::memory_order_relaxed); }
+    void Release();
+
+    void Push();
+
+    std::atomic<uint32> _refCount{};
+    std::atomic<uint8> _state{};
+    bool _isPrepared{};
+    AsyncCompletionQueue* _queue{ nullptr };
+    uint32 _callbackSlot{};
+    QueryResult _result;
+    PreparedQueryResult _preparedResult;
+    AsyncCompletion* _nextFree{ nullptr };
+
+    AsyncCompletion(AsyncCompletion const& right) = delete;
+    AsyncCompletion& operator=(AsyncCompletion const& right) = delete;
+};
+
+//! Intrusive reference to a pooled AsyncCompletion
+class WH_DATABASE_API AsyncCompletionPtr
+{
+public:
+    AsyncCompletionPtr() = default;
+
+    //! Takes over a reference already held by the caller if addRef is false
+    explicit AsyncCompletionPtr(AsyncCompletion* completion, bool addRef = true) : _completion(completion)
+    {
+        if (_completion && addRef)
+            _completion->AddRef();
+    }
+
+    AsyncCompletionPtr(AsyncCompletionPtr const& right) : AsyncCompletionPtr(right._completion) { }
+    AsyncCompletionPtr(AsyncCompletionPtr&& right) noexcept : _completion(std::exchange(right._completion, nullptr)) { }
+
+    AsyncCompletionPtr& operator=(AsyncCompletionPtr const& right)
+    {
+        AsyncCompletionPtr(right).Swap(*this);
+        return *this;
+    }
+
+    AsyncCompletionPtr& operator=(AsyncCompletionPtr&& right) noexcept
+    {
+        AsyncCompletionPtr(std::move(right)).Swap(*this);
+        return *this;
+    }
+
+    ~AsyncCompletionPtr()
+    {
+        if (_completion)
+            _completion->Release();
+    }
+
+    //! Gives up the reference without releasing it
+    [[nodiscard]] inline AsyncCompletion* Detach() { return std::exchange(_completion, nullptr); }
+
+    inline void Swap(AsyncCompletionPtr& right) noexcept { std::swap(_completion, right._completion); }
+
+    [[nodiscard]] inline AsyncCompletion* get() const { return _completion; }
+    inline AsyncCompletion* operator->() const { return _completion; }
+    inline AsyncCompletion& operator*() const { return *_completion; }
+    explicit operator bool() const { return _completion != nullptr; }
+
+    friend bool operator==(AsyncCompletionPtr const& left, AsyncCompletionPtr const& right) { return left._completion == right._completion; }
+
+private:
+    AsyncCompletion* _completion{ nullptr };
+};
+
+#endif
@@ -19,13 +19,14 @@
 #include "DatabaseWorkerPool.h"
 #include "MySQLConnection.h"
 #include "QueryResult.h"
+#include "QueryResultCache.h"
 #include <utility>
 
 BasicStatementTask::BasicStatementTask(std::string_view sql, bool isAsync /*= false*/) :
     AsyncOperation(isAsync), _sql(sql)
 {
     if (_hasResult)
-        _result = std::make_unique<QueryResultPromise>();
+        _completion = AsyncCompletion::Create(false);
 }
 
 void BasicStatementTask::ExecuteQuery()
@@ -34,43 +35,88 @@ void BasicStatementTask::ExecuteQuery()
     {
         auto result = _connection->Query(_sql);
         if (!result || !result->GetRowCount() || !result->NextRow())
-        {
-            _result->set_value(QueryResult(nullptr));
-            return;
-        }
+            result = nullptr;
 
-        _result->set_value(result);
+        _completion->SetResult(std::move(result));
+        _completion->Complete();
         return;
     }
 
     _connection->Execute(_sql);
 }
 
+void BasicStatementTask::Cancel()
+{
+    if (!_completion)
+        return;
+
+    // Completed without result, the processor frees the callback
+    _completion->Cancel();
+    _completion->Complete();
+}
+
 PreparedStatementTask::PreparedStatementTask(PreparedStatement stmt, bool isAsync /*= false*/) :
     AsyncOperation(isAsync), _stmt(std::move(stmt))
 {
     if (_hasResult)
-        _result = std::make_unique<PreparedQueryResultPromise>();
+        _completion = AsyncCompletion::Create(true);
 }
 
+PreparedStatementTask::PreparedStatementTask(PreparedStatement stmt, AsyncCompletionPtr completion) :
+    AsyncOperation(true), _stmt(std::move(stmt)), _completion(std::move(completion)) { }
+
 void PreparedStatementTask::ExecuteQuery()
 {
     if (_hasResult)
     {
+        uint64 cacheGeneration = _cache ? _cache->GetGeneration() : 0;
+
         auto result = _connection->Query(_stmt);
-        if (!result || !result->GetRowCount())
+
+        if (!result && _fallbackPool)
         {
-            _result->set_value({ nullptr });
+            auto task = new PreparedStatementTask(std::move(_stmt), std::move(_completion));
+            task->SetDeadline(_deadline);
+            task->SetPriority(_priority);
+            _fallbackPool->Enqueue(task);
             return;
         }
 
-        _result->set_value(result);
+        if (_cache)
+            _cache->Store(std::move(_cacheKey), result.get(), cacheGeneration);
+
+        if (!result || !result->GetRowCount())
+            result = nullptr;
+
+        _completion->SetResult(std::move(result));
+        _completion->Complete();
         return;
     }
 
     _connection->Execute(_stmt);
 }
 
+bool PreparedStatementTask::ExecuteGrouped()
+{
+    return _connection->Execute(_stmt);
+}
+
+void PreparedStatementTask::OnGroupCommitted()
+{
+    // Concurrent reads could cache the old rows again until the commit
+    if (QueryResultCache* cache = _connection->GetResultCache())
+        cache->Invalidate(*_stmt);
+}
+
+void PreparedStatementTask::Cancel()
+{
+    if (!_completion)
+        return;
+
+    _completion->Cancel();
+    _completion->Complete();
+}
+
 void CheckAsyncQueueTask::Execute()
 {
     _dbPool->CheckAsyncQueue();
@@ -18,24 +18,71 @@
 #ifndef _DATABASE_ASYNC_OPERATION_H_
 #define _DATABASE_ASYNC_OPERATION_H_
 
+#include "AsyncCompletion.h"
 #include "DatabaseEnvFwd.h"
+#include "DatabaseObjectPool.h"
+#include "Duration.h"
+#include <optional>
 
 class DatabaseWorkerPool;
+class QueryResultCache;
 
 class WH_DATABASE_API AsyncOperation
 {
 public:
     explicit AsyncOperation(bool isAsync = false) :
-        _hasResult(isAsync) { }
+        _hasResult(isAsync), _priority(isAsync ? QueryPriority::Interactive : QueryPriority::Background) { }
 
     virtual ~AsyncOperation() = default;
 
+    //! Tasks are created for every query, their memory is recycled by the pool. Sized delete gets the size of the derived task.
+    static void* operator new(std::size_t size) { return DatabaseObjectPool::Allocate(size); }
+    static void operator delete(void* ptr, std::size_t size) noexcept { DatabaseObjectPool::Deallocate(ptr, size); }
+
     virtual void ExecuteQuery() = 0;
     inline void SetConnection(MySQLConnection* connection) { _connection = connection; }
 
+    //! Operation is dropped by the worker instead of executed, its result is never read
+    virtual void Cancel() { }
+    [[nodiscard]] virtual bool IsCancelled() const { return false; }
+
+    //! Called by the worker right before ExecuteQuery, an operation cancelled before can't be started
+    virtual bool TryStart() { return true; }
+
+    //! Operation isn't executed after the deadline, a running query is interrupted by the server
+    inline void SetDeadline(TimePoint deadline) { _deadline = deadline; }
+    [[nodiscard]] inline TimePoint GetDeadline() const { return _deadline; }
+    [[nodiscard]] inline bool HasDeadline() const { return _deadline != TimePoint::max(); }
+
+    //! One-way write that can share a transaction with other writes (group commit).
+    //! Only prepared writes, raw SQL could commit implicitly (DDL, LOCK TABLES, TRUNCATE) and end the group transaction.
+    [[nodiscard]] virtual bool IsGroupable() const { return false; }
+
+    //! Executes a groupable write inside the transaction of its group, returns false if the statement failed
+    virtual bool ExecuteGrouped() { ExecuteQuery(); return true; }
+
+    //! Called after the transaction of its group is committed
+    virtual void OnGroupCommitted() { }
+
+    //! Queries with result are interactive by default, one-way operations are background work
+    inline void SetPriority(QueryPriority priority) { _priority = priority; }
+    [[nodiscard]] inline QueryPriority GetPriority() const { return _priority; }
+
+    //! Set by ExecuteQuery, the worker queues the operation again for the time instead of deleting it
+    inline void ScheduleRetry(TimePoint time) { _retryTime = time; }
+    [[nodiscard]] inline std::optional<TimePoint> TakeRetryTime() { return std::exchange(_retryTime, std::nullopt); }
+
+    inline void SetEnqueueTime(TimePoint time) { _enqueueTime = time; }
+    [[nodiscard]] inline TimePoint GetEnqueueTime() const { return _enqueueTime; }
+    [[nodiscard]] inline Microseconds GetQueueTime(TimePoint now) const { return std::chrono::duration_cast<Microseconds>(now - _enqueueTime); }
+
 protected:
     MySQLConnection* _connection{ nullptr };
+    TimePoint _enqueueTime;
+    TimePoint _deadline{ TimePoint::max() };
+    std::optional<TimePoint> _retryTime;
     bool _hasResult{};
+    QueryPriority _priority;
 
 private:
     AsyncOperation(AsyncOperation const& right) = delete;
@@ -49,25 +96,51 @@ public:
     ~BasicStatementTask() override = default;
 
     void ExecuteQuery() override;
-    [[nodiscard]] QueryResultFuture GetFuture() const { return _result->get_future(); }
+    void Cancel() override;
+    [[nodiscard]] bool IsCancelled() const override { return _completion && _completion->IsCancelled(); }
+    bool TryStart() override { return !_completion || _completion->TryStart(); }
+    [[nodiscard]] AsyncCompletionPtr const& GetCompletion() const { return _completion; }
 
 private:
     std::string _sql;
-    std::unique_ptr<QueryResultPromise> _result;
+    AsyncCompletionPtr _completion;
 };
 
 class WH_DATABASE_API PreparedStatementTask : public AsyncOperation
 {
 public:
     explicit PreparedStatementTask(PreparedStatement stmt, bool isAsync = false);
+
+    //! Completes the query of another task
+    PreparedStatementTask(PreparedStatement stmt, AsyncCompletionPtr completion);
     ~PreparedStatementTask() override = default;
 
     void ExecuteQuery() override;
-    [[nodiscard]] PreparedQueryResultFuture GetFuture() const { return _result->get_future(); }
+    void Cancel() override;
+    [[nodiscard]] bool IsCancelled() const override { return _completion && _completion->IsCancelled(); }
+    bool TryStart() override { return !_completion || _completion->TryStart(); }
+    [[nodiscard]] AsyncCompletionPtr const& GetCompletion() const { return _completion; }
+
+    [[nodiscard]] bool IsGroupable() const override { return !_hasResult && !HasDeadline(); }
+    bool ExecuteGrouped() override;
+    void OnGroupCommitted() override;
+
+    //! Result is stored in the cache under the key when the query is done
+    inline void SetResultCache(QueryResultCache* cache, std::string key)
+    {
+        _cache = cache;
+        _cacheKey = std::move(key);
+    }
+
+    //! Query executed on a replica is enqueued to the pool again if it fails
+    inline void SetFallback(DatabaseWorkerPool* pool) { _fallbackPool = pool; }
 
 private:
     PreparedStatement _stmt;
-    std::unique_ptr<PreparedQueryResultPromise> _result;
+    AsyncCompletionPtr _completion;
+    QueryResultCache* _cache{ nullptr };
+    std::string _cacheKey;
+    DatabaseWorkerPool* _fallbackPool{ nullptr };
 };
 
 class WH_DATABASE_API CheckAsyncQueueTask
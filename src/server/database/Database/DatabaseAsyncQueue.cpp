@@ -0,0 +1,193 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "DatabaseAsyncQueue.h"
+#include "DatabaseAsyncOperation.h"
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+    // Operations taken from a lane per round while the other lanes are busy too
+    constexpr std::array<uint32, static_cast<std::size_t>(QueryPriority::Max)> LANE_WEIGHTS = { 8, 2, 1 };
+}
+
+void AsyncOperationQueue::Push(AsyncOperation* operation)
+{
+    uint8 const lane = static_cast<uint8>(operation->GetPriority());
+
+    std::lock_guard<std::mutex> lock(_queueLock);
+    _lanes[lane].push_back(operation);
+    _sizes[lane].fetch_add(1, std::memory_order_relaxed);
+    _condition.notify_one();
+}
+
+void AsyncOperationQueue::PushDelayed(AsyncOperation* operation, TimePoint time)
+{
+    std::lock_guard<std::mutex> lock(_queueLock);
+    _delayed.emplace_back(time, operation);
+    std::push_heap(_delayed.begin(), _delayed.end(), std::greater<>());
+
+    // Waiting worker has to wake up in time
+    _condition.notify_one();
+}
+
+void AsyncOperationQueue::WaitAndPop(AsyncOperation*& operation, std::atomic<bool> const& customCancel)
+{
+    std::unique_lock<std::mutex> lock(_queueLock);
+
+    for (;;)
+    {
+        if (_shutdown || customCancel)
+            return;
+
+        PushDueOperations(std::chrono::steady_clock::now());
+
+        if (Size() > 0)
+            break;
+
+        if (_delayed.empty())
+            _condition.wait(lock);
+        else
+            _condition.wait_until(lock, _delayed.front().first);
+    }
+
+    operation = PopNext();
+}
+
+void AsyncOperationQueue::PushDueOperations(TimePoint now)
+{
+    while (!_delayed.empty() && _delayed.front().first <= now)
+    {
+        AsyncOperation* operation = _delayed.front().second;
+        std::pop_heap(_delayed.begin(), _delayed.end(), std::greater<>());
+        _delayed.pop_back();
+
+        uint8 const lane = static_cast<uint8>(operation->GetPriority());
+        _lanes[lane].push_back(operation);
+        _sizes[lane].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+AsyncOperation* AsyncOperationQueue::PopNext()
+{
+    for (;;)
+    {
+        auto& lane = _lanes[_currentLane];
+
+        if (!lane.empty() && _deficit[_currentLane])
+        {
+            --_deficit[_currentLane];
+            _sizes[_currentLane].fetch_sub(1, std::memory_order_relaxed);
+
+            AsyncOperation* operation = lane.front();
+            lane.pop_front();
+            return operation;
+        }
+
+        // Lane used its share or has nothing to do, next one starts its turn.
+        // A queued operation is found within one round.
+        _deficit[_currentLane] = 0;
+        _currentLane = (_currentLane + 1) % LANE_COUNT;
+        _deficit[_currentLane] = LANE_WEIGHTS[_currentLane];
+    }
+}
+
+void AsyncOperationQueue::SetGroupCommit(uint32 maxWrites, Milliseconds window)
+{
+    std::lock_guard<std::mutex> lock(_queueLock);
+    _groupCommitMaxWrites.store(maxWrites, std::memory_order_relaxed);
+    _groupCommitWindow = window;
+}
+
+void AsyncOperationQueue::PopGroupedWrites(std::vector<AsyncOperation*>& group, std::atomic<bool> const& customCancel)
+{
+    uint8 const lane = static_cast<uint8>(group.front()->GetPriority());
+
+    std::unique_lock<std::mutex> lock(_queueLock);
+
+    uint32 const maxWrites = _groupCommitMaxWrites.load(std::memory_order_relaxed);
+    TimePoint const windowEnd = std::chrono::steady_clock::now() + _groupCommitWindow;
+
+    while (group.size() < maxWrites && !_shutdown && !customCancel)
+    {
+        auto& writes = _lanes[lane];
+
+        if (writes.empty())
+        {
+            if (_condition.wait_until(lock, windowEnd) == std::cv_status::timeout)
+                break;
+
+            // Something else was pushed, the wakeup is passed on to an idle worker
+            if (writes.empty() && Size() > 0)
+            {
+                _condition.notify_one();
+                break;
+            }
+
+            continue;
+        }
+
+        if (!writes.front()->IsGroupable())
+            break;
+
+        group.push_back(writes.front());
+        writes.pop_front();
+        _sizes[lane].fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void AsyncOperationQueue::Cancel()
+{
+    std::lock_guard<std::mutex> lock(_queueLock);
+
+    for (std::size_t i{}; i < LANE_COUNT; ++i)
+    {
+        for (AsyncOperation* operation : _lanes[i])
+            delete operation;
+
+        _lanes[i].clear();
+        _sizes[i].store(0, std::memory_order_relaxed);
+    }
+
+    for (auto const& [time, operation] : _delayed)
+        delete operation;
+
+    _delayed.clear();
+
+    _shutdown = true;
+    _condition.notify_all();
+}
+
+void AsyncOperationQueue::NotifyAll()
+{
+    std::lock_guard<std::mutex> lock(_queueLock);
+    _condition.notify_all();
+}
+
+std::size_t AsyncOperationQueue::Size() const
+{
+    std::size_t size{};
+
+    for (auto const& laneSize : _sizes)
+        size += laneSize.load(std::memory_order_relaxed);
+
+    return size;
+}
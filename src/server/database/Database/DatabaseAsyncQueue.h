@@ -0,0 +1,93 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DATABASE_ASYNC_QUEUE_H_
+#define _DATABASE_ASYNC_QUEUE_H_
+
+#include "DatabaseEnvFwd.h"
+#include "Duration.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class AsyncOperation;
+
+/**
+    Queue of async operations with a lane per QueryPriority, shared by the async workers of a pool.
+
+    Lanes are dequeued by deficit round robin: while all lanes are busy, every round takes up to
+    the weight of a lane from it, so interactive queries are not stuck behind bulk writes and
+    background work still progresses. Operations of one lane are executed in FIFO order.
+*/
+class WH_DATABASE_API AsyncOperationQueue
+{
+public:
+    AsyncOperationQueue() = default;
+    ~AsyncOperationQueue() = default;
+
+    void Push(AsyncOperation* operation);
+
+    //! Operation is pushed to its lane when the time is reached, used to retry without blocking a worker
+    void PushDelayed(AsyncOperation* operation, TimePoint time);
+
+    //! Blocks until an operation is queued, operation is not set if the queue or the worker was cancelled
+    void WaitAndPop(AsyncOperation*& operation, std::atomic<bool> const& customCancel);
+
+    //! Group commit is disabled if maxWrites is lower than 2
+    void SetGroupCommit(uint32 maxWrites, Milliseconds window);
+    [[nodiscard]] inline bool IsGroupCommitEnabled() const { return _groupCommitMaxWrites.load(std::memory_order_relaxed) > 1; }
+
+    //! Adds the groupable writes following the first operation of the group in its lane, see AsyncOperation::IsGroupable.
+    //! Waits up to the group commit window for more writes, stops at the first operation that can't be grouped.
+    void PopGroupedWrites(std::vector<AsyncOperation*>& group, std::atomic<bool> const& customCancel);
+
+    //! Deletes queued operations, waiting workers return
+    void Cancel();
+    void NotifyAll();
+
+    [[nodiscard]] std::size_t Size() const;
+    [[nodiscard]] inline std::size_t Size(QueryPriority priority) const { return _sizes[static_cast<uint8>(priority)].load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t LANE_COUNT = static_cast<std::size_t>(QueryPriority::Max);
+
+    //! Queue lock must be held, at least one lane must not be empty
+    AsyncOperation* PopNext();
+
+    //! Queue lock must be held
+    void PushDueOperations(TimePoint now);
+
+    mutable std::mutex _queueLock;
+    std::condition_variable _condition;
+    std::array<std::deque<AsyncOperation*>, LANE_COUNT> _lanes;
+    std::array<std::atomic<std::size_t>, LANE_COUNT> _sizes{}; ///< Depth of the lanes, read without the lock
+    std::array<uint32, LANE_COUNT> _deficit{}; ///< Operations the current round may still take from the lane
+    std::vector<std::pair<TimePoint, AsyncOperation*>> _delayed; ///< Min heap by time
+    uint8 _currentLane{};
+    bool _shutdown{};
+    std::atomic<uint32> _groupCommitMaxWrites{};
+    Milliseconds _groupCommitWindow{};
+
+    AsyncOperationQueue(AsyncOperationQueue const& right) = delete;
+    AsyncOperationQueue& operator=(AsyncOperationQueue const& right) = delete;
+};
+
+#endif // _DATABASE_ASYNC_QUEUE_H_
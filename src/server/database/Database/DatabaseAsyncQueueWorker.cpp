@@ -17,9 +17,15 @@
 
 #include "DatabaseAsyncQueueWorker.h"
 #include "DatabaseAsyncOperation.h"
+#include "DatabaseAsyncQueue.h"
+#include "Log.h"
+#include "MySQLConnection.h"
 #include "PCQueue.h"
+#include "QueryStatistics.h"
+#include <algorithm>
+#include <mysqld_error.h>
 
-AsyncDBQueueWorker::AsyncDBQueueWorker(ProducerConsumerQueue<AsyncOperation*>* dbQueue, MySQLConnection* connection)
+AsyncDBQueueWorker::AsyncDBQueueWorker(AsyncOperationQueue* dbQueue, MySQLConnection* connection)
 {
     _connection = connection;
     _queue = dbQueue;
@@ -52,10 +58,138 @@ void AsyncDBQueueWorker::ExecuteAsyncQueue()
         if (!operation)
             continue;
 
+        auto statistics = _connection->GetStatistics();
+
+        if (statistics)
+            statistics->RecordQueueWait(operation->GetQueueTime(std::chrono::steady_clock::now()));
+
+        // Operation is parked while the server is unreachable, it fails on the closed connection when its deadline passes
+        if (!_connection->IsConnected() && _connection->GetCircuitBreaker())
+            _connection->WaitForReconnect(std::min(operation->GetDeadline(), _connection->GetParkDeadline(operation->GetEnqueueTime())));
+
+        // Nobody reads the result anymore, don't spend the connection on it
+        TimePoint const now = std::chrono::steady_clock::now();
+        if (now >= operation->GetDeadline() || !operation->TryStart())
+        {
+            if (statistics)
+                statistics->RecordDropped();
+
+            operation->Cancel();
+            delete operation;
+            continue;
+        }
+
+        // Writes queued behind it share its transaction
+        if (operation->IsGroupable() && _queue->IsGroupCommitEnabled())
+        {
+            _group.push_back(operation);
+            _queue->PopGroupedWrites(_group, _cancel);
+
+            if (_group.size() > 1)
+            {
+                ExecuteGroup();
+                continue;
+            }
+
+            _group.clear();
+        }
+
+        // Server interrupts the query when the deadline passes
+        _connection->SetStatementTimeLimit(operation->HasDeadline() ? std::chrono::duration_cast<Milliseconds>(operation->GetDeadline() - now) : 0ms);
+
         operation->SetConnection(_connection);
         operation->ExecuteQuery();
-        delete operation;
+
+        // Retry waits in the queue, the worker isn't blocked by the backoff
+        if (auto retryTime = operation->TakeRetryTime())
+            _queue->PushDelayed(operation, *retryTime);
+        else
+            delete operation;
+    }
+}
+
+void AsyncDBQueueWorker::ExecuteGroup()
+{
+    auto statistics = _connection->GetStatistics();
+    TimePoint const now = std::chrono::steady_clock::now();
+
+    if (statistics)
+        for (std::size_t i = 1; i < _group.size(); ++i)
+            statistics->RecordQueueWait(_group[i]->GetQueueTime(now));
+
+    // Grouped writes have no deadline
+    _connection->SetStatementTimeLimit(0ms);
+
+    // One commit, so one log flush of the server, for all writes of the group
+    bool success = _connection->BeginTransaction();
+
+    for (AsyncOperation*& operation : _group)
+    {
+        if (!success)
+            break;
+
+        operation->SetConnection(_connection);
+
+        success = _connection->SetSavepoint();
+        if (!success || operation->ExecuteGrouped())
+            continue;
+
+        // Deadlock rolled back the whole transaction, otherwise only the failed write is undone
+        success = _connection->GetLastError() != ER_LOCK_DEADLOCK && _connection->RollbackToSavepoint();
+        if (success)
+        {
+            delete operation;
+            operation = nullptr;
+        }
+    }
+
+    bool commitLost{};
+
+    if (success)
+    {
+        success = _connection->CommitTransaction();
+
+        // Server could have committed before the connection dropped
+        commitLost = !success && !_connection->IsConnected();
     }
+    else
+        _connection->RollbackTransaction();
+
+    if (success)
+    {
+        for (AsyncOperation* operation : _group)
+            if (operation)
+                operation->OnGroupCommitted();
+
+        if (statistics)
+            statistics->RecordGroupCommit(_group.size());
+    }
+    else if (commitLost)
+    {
+        // Writes executed twice could be applied twice, they are dropped instead
+        LOG_ERROR("db.query", "Connection was lost during the group commit of {} writes, they are not executed again", _group.size());
+    }
+    else
+    {
+        LOG_WARN("db.query", "Group commit of {} writes failed, executing them one by one", _group.size());
+
+        if (!_connection->IsConnected() && _connection->GetCircuitBreaker())
+            _connection->WaitForReconnect(_connection->GetParkDeadline(_group.front()->GetEnqueueTime()));
+
+        for (AsyncOperation* operation : _group)
+        {
+            if (!operation)
+                continue;
+
+            operation->SetConnection(_connection);
+            operation->ExecuteQuery();
+        }
+    }
+
+    for (AsyncOperation* operation : _group)
+        delete operation;
+
+    _group.clear();
 }
 
 AsyncDBQueueChecker::AsyncDBQueueChecker(ProducerConsumerQueue<CheckAsyncQueueTask*>* dbQueue)
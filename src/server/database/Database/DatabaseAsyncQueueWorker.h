@@ -21,25 +21,31 @@
 #include "Define.h"
 #include <atomic>
 #include <thread>
+#include <vector>
 
 template <typename T>
 class ProducerConsumerQueue;
 
 class AsyncOperation;
+class AsyncOperationQueue;
 class CheckAsyncQueueTask;
 class MySQLConnection;
 
 class WH_DATABASE_API AsyncDBQueueWorker
 {
 public:
-    AsyncDBQueueWorker(ProducerConsumerQueue<AsyncOperation*>* dbQueue, MySQLConnection* connection);
+    AsyncDBQueueWorker(AsyncOperationQueue* dbQueue, MySQLConnection* connection);
     ~AsyncDBQueueWorker();
 
 private:
     void ExecuteAsyncQueue();
 
-    ProducerConsumerQueue<AsyncOperation*>* _queue;
+    //! Executes the writes of the group in one transaction, they are executed one by one if the transaction fails
+    void ExecuteGroup();
+
+    AsyncOperationQueue* _queue;
     MySQLConnection* _connection;
+    std::vector<AsyncOperation*> _group; ///< Writes of the current group commit
 
     std::thread _thread;
     std::atomic<bool> _cancel{ false };
@@ -0,0 +1,121 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "DatabaseCircuitBreaker.h"
+#include "Log.h"
+#include "Random.h"
+#include <algorithm>
+
+Milliseconds GetBackoffDelay(uint32 failedAttempts, Milliseconds minDelay, Milliseconds maxDelay)
+{
+    // Shift is capped, the delay reaches the max long before
+    Milliseconds delay = std::min(maxDelay, minDelay * (int64(1) << std::min<uint32>(failedAttempts, 20)));
+    return delay / 2 + randtime(0ms, delay / 2);
+}
+
+void DatabaseCircuitBreaker::SetReconnectDelays(Milliseconds minDelay, Milliseconds maxDelay)
+{
+    std::lock_guard guard(_mutex);
+    _minDelay = minDelay;
+    _maxDelay = std::max(minDelay, maxDelay);
+}
+
+void DatabaseCircuitBreaker::Trip()
+{
+    std::lock_guard guard(_mutex);
+
+    if (GetState() != State::Closed)
+        return;
+
+    LOG_ERROR("db.connection", "Lost the connection to the MySQL server! Sync queries fail and async ones wait until it's back.");
+
+    _failedProbes = 0;
+    _probeTime = std::chrono::steady_clock::now();
+    _state.store(State::Open, std::memory_order_release);
+}
+
+bool DatabaseCircuitBreaker::TryProbe()
+{
+    std::lock_guard guard(_mutex);
+
+    if (_stopped || GetState() != State::Open || std::chrono::steady_clock::now() < _probeTime)
+        return false;
+
+    _state.store(State::HalfOpen, std::memory_order_release);
+    return true;
+}
+
+void DatabaseCircuitBreaker::ReportProbe(bool isConnected)
+{
+    {
+        std::lock_guard guard(_mutex);
+
+        if (isConnected)
+        {
+            LOG_INFO("db.connection", "Reconnected to the MySQL server after {} failed attempts", _failedProbes);
+            _failedProbes = 0;
+            _state.store(State::Closed, std::memory_order_release);
+        }
+        else
+        {
+            Milliseconds delay = GetBackoffDelay(_failedProbes++, _minDelay, _maxDelay);
+            LOG_WARN("db.connection", "Could not reconnect to the MySQL server, next attempt in {} ms", delay.count());
+            _probeTime = std::chrono::steady_clock::now() + delay;
+            _state.store(State::Open, std::memory_order_release);
+        }
+    }
+
+    _condition.notify_all();
+}
+
+bool DatabaseCircuitBreaker::WaitForProbe(TimePoint deadline)
+{
+    std::unique_lock lock(_mutex);
+
+    while (!_stopped && GetState() != State::Closed)
+    {
+        auto const now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+            break;
+
+        if (GetState() == State::Open && now >= _probeTime)
+            break;
+
+        _condition.wait_until(lock, GetState() == State::Open ? std::min(deadline, _probeTime) : deadline);
+    }
+
+    return !_stopped;
+}
+
+void DatabaseCircuitBreaker::Stop()
+{
+    {
+        std::lock_guard guard(_mutex);
+        _stopped = true;
+    }
+
+    _condition.notify_all();
+}
+
+uint32 DatabaseCircuitBreaker::GetFailedProbes() const
+{
+    std::lock_guard guard(_mutex);
+    return _failedProbes;
+}
@@ -0,0 +1,92 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DATABASE_CIRCUIT_BREAKER_H
+#define _DATABASE_CIRCUIT_BREAKER_H
+
+#include "Define.h"
+#include "Duration.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+//! Delay of the first reconnection attempt after a failed one, doubled after every failure up to the max delay
+constexpr Milliseconds DEFAULT_RECONNECT_MIN_DELAY = 500ms;
+constexpr Milliseconds DEFAULT_RECONNECT_MAX_DELAY = 30s;
+
+//! Time async operations wait in the queue for a lost server before they fail
+constexpr Milliseconds DEFAULT_RECONNECT_PARK_TIMEOUT = 30s;
+
+//! Exponential backoff, half of the delay is random so connections of many processes don't reconnect at once
+WH_DATABASE_API Milliseconds GetBackoffDelay(uint32 failedAttempts, Milliseconds minDelay, Milliseconds maxDelay);
+
+/**
+    Connection state of the server of a pool, shared by its connections.
+
+    Lost connection opens the breaker. While it's open sync queries fail at once and async operations
+    are parked by their workers until the server is back or their deadline passes. Only one connection
+    probes the server after the backoff delay, the others reconnect once the probe succeeded.
+*/
+class WH_DATABASE_API DatabaseCircuitBreaker
+{
+public:
+    enum class State : uint8
+    {
+        Closed,     ///< Server is reachable
+        Open,       ///< Server is lost, waiting for the next probe
+        HalfOpen    ///< A connection is probing the server
+    };
+
+    DatabaseCircuitBreaker() = default;
+
+    void SetReconnectDelays(Milliseconds minDelay, Milliseconds maxDelay);
+    inline void SetParkTimeout(Milliseconds timeout) { _parkTimeout = timeout; }
+    [[nodiscard]] inline Milliseconds GetParkTimeout() const { return _parkTimeout; }
+
+    //! Called when a connection is lost, the first probe is allowed at once
+    void Trip();
+
+    //! True if the caller must probe the server now and report the result
+    bool TryProbe();
+    void ReportProbe(bool isConnected);
+
+    //! Blocks until a probe is allowed, the breaker closes or the deadline passes. False if the pool is closing.
+    bool WaitForProbe(TimePoint deadline);
+
+    //! Wakes parked workers on pool close, they don't wait for the server anymore
+    void Stop();
+
+    [[nodiscard]] inline State GetState() const { return _state.load(std::memory_order_acquire); }
+    [[nodiscard]] inline bool IsClosed() const { return GetState() == State::Closed; }
+    [[nodiscard]] uint32 GetFailedProbes() const;
+
+private:
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    std::atomic<State> _state{ State::Closed };
+    bool _stopped{};
+    uint32 _failedProbes{};
+    TimePoint _probeTime;
+    Milliseconds _minDelay{ DEFAULT_RECONNECT_MIN_DELAY };
+    Milliseconds _maxDelay{ DEFAULT_RECONNECT_MAX_DELAY };
+    Milliseconds _parkTimeout{ DEFAULT_RECONNECT_PARK_TIMEOUT };
+
+    DatabaseCircuitBreaker(DatabaseCircuitBreaker const& right) = delete;
+    DatabaseCircuitBreaker& operator=(DatabaseCircuitBreaker const& right) = delete;
+};
+
+#endif
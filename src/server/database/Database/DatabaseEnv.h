@@ -22,6 +22,7 @@
 #include "PreparedStatement.h"
 #include "QueryCallback.h"
 #include "QueryResult.h"
+#include "RowSchema.h"
 #include "Transaction.h"
 
 // Impl include
@@ -29,7 +29,23 @@ enum class ConnectionFlags : uint8
 {
     Async   = 0x1,
     Sync    = 0x2,
-    Both    = Async | Sync
+    Both    = Async | Sync,
+
+    // Statement only reads, it's executed on a replica if the pool has one
+    ReadOnly        = 0x4,
+    AsyncReadOnly   = Async | ReadOnly,
+    SyncReadOnly    = Sync | ReadOnly,
+    BothReadOnly    = Both | ReadOnly
+};
+
+//! Lane of the async queue, see AsyncOperationQueue
+enum class QueryPriority : uint8
+{
+    Interactive,    ///< Results somebody waits for, e.g. replies to commands
+    Background,     ///< Writes and transactions
+    Maintenance,    ///< Pings and health checks
+
+    Max
 };
 
 enum class DatabaseType : uint8
@@ -49,13 +65,9 @@ struct QueryResultFieldMetadata;
 
 class ResultSet;
 using QueryResult = std::shared_ptr<ResultSet>;
-using QueryResultFuture = std::future<QueryResult>;
-using QueryResultPromise = std::promise<QueryResult>;
 
 class PreparedResultSet;
 using PreparedQueryResult = std::shared_ptr<PreparedResultSet>;
-using PreparedQueryResultFuture = std::future<PreparedQueryResult>;
-using PreparedQueryResultPromise = std::promise<PreparedQueryResult>;
 
 class PreparedStatementBase;
 using PreparedStatement = std::shared_ptr<PreparedStatementBase>;
@@ -70,10 +82,12 @@ using QueryResultHolderFuture = std::future<void>;
 using QueryResultHolderPromise = std::promise<void>;
 using SQLQueryHolder = std::shared_ptr<SQLQueryHolderBase>;
 
+class AsyncCompletion;
+class AsyncCompletionPtr;
 class QueryCallback;
+class QueryCallbackProcessor;
 class SQLQueryHolderCallback;
 class TransactionCallback;
-using QueryCallbackProcessor = AsyncCallbackProcessor<QueryCallback>;
 using TransactionCallbackProcessor = AsyncCallbackProcessor<TransactionCallback>;
 using QueryHolderCallbackProcessor = AsyncCallbackProcessor<SQLQueryHolderCallback>;
 
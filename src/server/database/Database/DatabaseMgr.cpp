@@ -21,12 +21,14 @@
 #include "DatabaseMgr.h"
 #include "Config.h"
 #include "DBUpdater.h"
+#include "DatabaseCircuitBreaker.h"
 #include "DatabaseWorkerPool.h"
 #include "Log.h"
 #include "Timer.h"
 #include <errmsg.h>
 #include <mysql.h>
 #include <mysqld_error.h>
+#include <thread>
 
 DatabaseMgr::DatabaseMgr()
 {
@@ -55,7 +57,11 @@ void DatabaseMgr::AddDatabase(DatabaseWorkerPool& pool, std::string_view name)
     // #2. Check option for enable auto update this pool
     bool const updatesEnabledForThis = DBUpdater::IsEnabled(pool, _updateFlags);
 
-    _open.emplace([this, name, updatesEnabledForThis, &pool]() -> bool
+    PoolLoader& loader = _loaders.emplace_back();
+    loader.Pool = &pool;
+    loader.Name = name;
+
+    loader.Steps.emplace_back("open", [this, name, updatesEnabledForThis, &pool]() -> bool
     {
        auto const dbString = sConfigMgr->GetOption<std::string>(std::string(name) + "DatabaseInfo", "");
        if (dbString.empty())
@@ -65,6 +71,7 @@ void DatabaseMgr::AddDatabase(DatabaseWorkerPool& pool, std::string_view name)
        }
 
        pool.SetConnectionInfo(dbString);
+       pool.SetReplicas(sConfigMgr->GetOption<std::string>(std::string(name) + "DatabaseInfo.Replicas", "", false));
 
        if (uint32 error = pool.Open())
        {
@@ -77,8 +84,10 @@ void DatabaseMgr::AddDatabase(DatabaseWorkerPool& pool, std::string_view name)
 
                while (reconnectCount < attempts)
                {
-                   LOG_WARN("db", "> Retrying after {} seconds", reconnectSeconds.count());
-                   std::this_thread::sleep_for(reconnectSeconds);
+                   // Server which is starting is retried soon, the delay grows up to the configured seconds
+                   Milliseconds delay = GetBackoffDelay(reconnectCount, DEFAULT_RECONNECT_MIN_DELAY, reconnectSeconds);
+                   LOG_WARN("db", "> Retrying after {} ms", delay.count());
+                   std::this_thread::sleep_for(delay);
                    error = pool.Open();
 
                    if (error == CR_CONNECTION_ERROR)
@@ -107,6 +116,7 @@ void DatabaseMgr::AddDatabase(DatabaseWorkerPool& pool, std::string_view name)
        }
 
        // Add the close operation
+       std::lock_guard<std::mutex> guard(_closeLock);
        _close.emplace([&pool]
        {
            pool.Close();
@@ -118,7 +128,7 @@ void DatabaseMgr::AddDatabase(DatabaseWorkerPool& pool, std::string_view name)
     // Populate and update only if updates are enabled for this pool
     if (updatesEnabledForThis)
     {
-        _populate.emplace([this, name, &pool]() -> bool
+        loader.Steps.emplace_back("populate", [name, &pool]() -> bool
         {
            if (!DBUpdater::Populate(pool))
            {
@@ -129,7 +139,7 @@ void DatabaseMgr::AddDatabase(DatabaseWorkerPool& pool, std::string_view name)
            return true;
         });
 
-        _update.emplace([this, name, &pool]() -> bool
+        loader.Steps.emplace_back("update", [this, name, &pool]() -> bool
         {
              if (!DBUpdater::Update(pool, _modulesList))
              {
@@ -141,7 +151,7 @@ void DatabaseMgr::AddDatabase(DatabaseWorkerPool& pool, std::string_view name)
         });
     }
 
-    _prepare.emplace([this, name, &pool]() -> bool
+    loader.Steps.emplace_back("prepare", [name, &pool]() -> bool
     {
         if (!pool.PrepareStatements())
         {
@@ -149,7 +159,6 @@ void DatabaseMgr::AddDatabase(DatabaseWorkerPool& pool, std::string_view name)
             return false;
         }
 
-        _poolList.emplace_back(&pool);
         return true;
     });
 }
@@ -159,68 +168,97 @@ bool DatabaseMgr::Load()
     if (!_updateFlags)
         LOG_INFO("db.update", "Automatic database updates are disabled for all databases!");
 
-    if (!OpenDatabases())
-        return false;
+    TimePoint const start = std::chrono::steady_clock::now();
+    _loadFailed = false;
 
-    if (!PopulateDatabases())
-        return false;
+    // Pools are opened, updated and prepared concurrently, one thread each
+    if (_loaders.size() == 1)
+        RunLoader(_loaders.front(), start);
+    else
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(_loaders.size());
 
-    if (!UpdateDatabases())
-        return false;
+        for (auto& loader : _loaders)
+        {
+            threads.emplace_back([this, &loader, start]()
+            {
+                RunLoader(loader, start);
+                mysql_thread_end();
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    LogTimeline(std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - start));
 
-    if (!PrepareStatements())
+    if (_loadFailed)
+    {
+        CloseDatabases();
         return false;
+    }
+
+    for (auto const& loader : _loaders)
+        _poolList.emplace_back(loader.Pool);
 
     return true;
 }
 
-bool DatabaseMgr::OpenDatabases()
+bool DatabaseMgr::RunLoader(PoolLoader& loader, TimePoint start)
 {
-    return Process(_open);
-}
+    for (auto& step : loader.Steps)
+    {
+        // Another pool failed, startup is aborted
+        if (_loadFailed)
+            return false;
 
-bool DatabaseMgr::PopulateDatabases()
-{
-    return Process(_populate);
-}
+        step.Started = true;
 
-bool DatabaseMgr::UpdateDatabases()
-{
-    return Process(_update);
-}
+        TimePoint const begin = std::chrono::steady_clock::now();
+        bool const result = step.Function();
+        TimePoint const end = std::chrono::steady_clock::now();
 
-bool DatabaseMgr::PrepareStatements()
-{
-    return Process(_prepare);
+        step.Begin = std::chrono::duration_cast<Microseconds>(begin - start);
+        step.Duration = std::chrono::duration_cast<Microseconds>(end - begin);
+        step.Done = result;
+
+        if (!result)
+        {
+            _loadFailed = true;
+            return false;
+        }
+    }
+
+    return true;
 }
 
-bool DatabaseMgr::Process(std::queue<Predicate>& queue)
+void DatabaseMgr::LogTimeline(Microseconds total) const
 {
-    while (!queue.empty())
+    LOG_INFO("db", ">> Databases loaded in {}", Warhead::Time::ToTimeString(total));
+
+    for (auto const& loader : _loaders)
     {
-        if (!queue.front()())
+        std::string timeline;
+
+        for (auto const& step : loader.Steps)
         {
-            // Close all open databases which have a registered close operation
-            while (!_close.empty())
-            {
-                _close.top()();
-                _close.pop();
-            }
+            if (!step.Started)
+                break;
 
-            return false;
+            timeline += Warhead::StringFormat("{}{} {} at {}{}", timeline.empty() ? "" : ", ", step.Name,
+                Warhead::Time::ToTimeString(step.Duration), Warhead::Time::ToTimeString(step.Begin), step.Done ? "" : " (failed)");
         }
 
-        queue.pop();
+        LOG_INFO("db", ">> {}: {}", loader.Name, timeline.empty() ? "not started" : timeline);
     }
-
-    return true;
 }
 
-void DatabaseMgr::CloseAllConnections()
+void DatabaseMgr::CloseDatabases()
 {
-    LOG_INFO("db", "> Close all database connections...");
+    std::lock_guard<std::mutex> guard(_closeLock);
 
-    // Close all open databases which have a registered close operation
     while (!_close.empty())
     {
         _close.top()();
@@ -228,6 +266,12 @@ void DatabaseMgr::CloseAllConnections()
     }
 }
 
+void DatabaseMgr::CloseAllConnections()
+{
+    LOG_INFO("db", "> Close all database connections...");
+    CloseDatabases();
+}
+
 void DatabaseMgr::Update(Milliseconds diff)
 {
     if (_poolList.empty())
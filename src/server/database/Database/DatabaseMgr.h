@@ -22,8 +22,9 @@
 #include "Duration.h"
 #include <atomic>
 #include <functional>
-#include <queue>
+#include <mutex>
 #include <stack>
+#include <string>
 #include <vector>
 
 class DatabaseWorkerPool;
@@ -53,20 +54,39 @@ private:
     using Predicate = std::function<bool()>;
     using Closer = std::function<void()>;
 
-    bool OpenDatabases();
-    bool PopulateDatabases();
-    bool UpdateDatabases();
-    bool PrepareStatements();
-
-    // Invokes all functions in the given queue and closes the databases on errors.
-    // Returns false when there was an error.
-    bool Process(std::queue<Predicate>& queue);
+    struct LoadStep
+    {
+        std::string_view Name;
+        Predicate Function;
+        Microseconds Begin{}; ///< Since the start of Load
+        Microseconds Duration{};
+        bool Started{};
+        bool Done{};
+    };
+
+    //! Steps of one pool run in order (open, populate, update, prepare), pools don't depend on each other
+    struct PoolLoader
+    {
+        DatabaseWorkerPool* Pool{};
+        std::string_view Name;
+        std::vector<LoadStep> Steps;
+    };
+
+    //! Runs the steps until one fails or another pool failed. Returns false when there was an error.
+    bool RunLoader(PoolLoader& loader, TimePoint start);
+    void LogTimeline(Microseconds total) const;
+
+    //! Closes all open databases which have a registered close operation
+    void CloseDatabases();
 
     std::string _modulesList;
     bool _autoSetup{};
     uint32 _updateFlags{};
 
-    std::queue<Predicate> _open, _populate, _update, _prepare;
+    std::vector<PoolLoader> _loaders;
+    std::atomic<bool> _loadFailed{};
+
+    std::mutex _closeLock;
     std::stack<Closer> _close;
     std::vector<DatabaseWorkerPool*> _poolList;
 
@@ -0,0 +1,179 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "DatabaseObjectPool.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+
+namespace
+{
+    constexpr std::size_t SIZE_CLASS_GRANULARITY = 32;
+    constexpr std::size_t MAX_POOLED_SIZE = 1024;
+    constexpr std::size_t SIZE_CLASS_COUNT = MAX_POOLED_SIZE / SIZE_CLASS_GRANULARITY;
+
+    constexpr uint32 THREAD_CACHE_LIMIT = 64;  // Blocks of one size class kept by a thread
+    constexpr uint32 TRANSFER_BATCH_SIZE = 32; // Blocks moved between a thread and the depot at once
+
+    struct FreeBlock
+    {
+        FreeBlock* Next;
+    };
+
+    struct FreeList
+    {
+        FreeBlock* Head{ nullptr };
+        uint32 Count{};
+
+        void Push(void* ptr)
+        {
+            auto block = static_cast<FreeBlock*>(ptr);
+            block->Next = Head;
+            Head = block;
+            ++Count;
+        }
+
+        FreeBlock* Pop()
+        {
+            FreeBlock* block = Head;
+            if (!block)
+                return nullptr;
+
+            Head = block->Next;
+            --Count;
+            return block;
+        }
+
+        void MoveTo(FreeList& to, uint32 count)
+        {
+            while (count-- && Head)
+                to.Push(Pop());
+        }
+    };
+
+    using SizeClassLists = std::array<FreeList, SIZE_CLASS_COUNT>;
+
+    // Constant initialized, blocks can be released by static destructors during shutdown
+    struct Depot
+    {
+        std::mutex Lock;
+        SizeClassLists Lists{};
+    };
+
+    constinit Depot SharedDepot;
+
+    std::atomic<uint64> Hits{};
+    std::atomic<uint64> Misses{};
+    std::atomic<uint64> Oversized{};
+
+    struct ThreadCache
+    {
+        SizeClassLists Lists{};
+
+        ~ThreadCache();
+    };
+
+    thread_local ThreadCache LocalCache;
+
+    // Trivially destructible, still valid after LocalCache is destroyed
+    constinit thread_local bool LocalCacheDestroyed = false;
+
+    ThreadCache::~ThreadCache()
+    {
+        std::lock_guard guard(SharedDepot.Lock);
+
+        for (std::size_t i{}; i < SIZE_CLASS_COUNT; ++i)
+            Lists[i].MoveTo(SharedDepot.Lists[i], Lists[i].Count);
+
+        LocalCacheDestroyed = true;
+    }
+
+    inline std::size_t GetSizeClass(std::size_t size)
+    {
+        return size ? (size - 1) / SIZE_CLASS_GRANULARITY : 0;
+    }
+}
+
+void* DatabaseObjectPool::Allocate(std::size_t size)
+{
+    if (size > MAX_POOLED_SIZE)
+    {
+        Oversized.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    std::size_t const sizeClass = GetSizeClass(size);
+
+    if (!LocalCacheDestroyed)
+    {
+        FreeList& list = LocalCache.Lists[sizeClass];
+
+        if (!list.Head)
+        {
+            std::lock_guard guard(SharedDepot.Lock);
+            SharedDepot.Lists[sizeClass].MoveTo(list, TRANSFER_BATCH_SIZE);
+        }
+
+        if (FreeBlock* block = list.Pop())
+        {
+            Hits.fetch_add(1, std::memory_order_relaxed);
+            return block;
+        }
+    }
+
+    Misses.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new((sizeClass + 1) * SIZE_CLASS_GRANULARITY);
+}
+
+void DatabaseObjectPool::Deallocate(void* ptr, std::size_t size) noexcept
+{
+    if (!ptr)
+        return;
+
+    if (size > MAX_POOLED_SIZE)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    std::size_t const sizeClass = GetSizeClass(size);
+
+    if (LocalCacheDestroyed)
+    {
+        std::lock_guard guard(SharedDepot.Lock);
+        SharedDepot.Lists[sizeClass].Push(ptr);
+        return;
+    }
+
+    FreeList& list = LocalCache.Lists[sizeClass];
+    list.Push(ptr);
+
+    // Threads freeing more than they allocate (async workers) hand blocks back to the allocating threads
+    if (list.Count > THREAD_CACHE_LIMIT)
+    {
+        std::lock_guard guard(SharedDepot.Lock);
+        list.MoveTo(SharedDepot.Lists[sizeClass], TRANSFER_BATCH_SIZE);
+    }
+}
+
+DatabaseObjectPoolStats DatabaseObjectPool::GetStats()
+{
+    return { Hits.load(std::memory_order_relaxed), Misses.load(std::memory_order_relaxed), Oversized.load(std::memory_order_relaxed) };
+}
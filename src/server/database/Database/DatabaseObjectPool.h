@@ -0,0 +1,70 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DATABASE_OBJECT_POOL_H
+#define _DATABASE_OBJECT_POOL_H
+
+#include "Define.h"
+#include <cstddef>
+#include <new>
+
+struct DatabaseObjectPoolStats
+{
+    uint64 Hits{};      ///< Served from recycled blocks
+    uint64 Misses{};    ///< Allocated because no block of the size class was free
+    uint64 Oversized{}; ///< Bigger than the largest size class, not pooled
+};
+
+/**
+    Memory pool of the small objects allocated for every query: async operations, prepared statements and their parameter lists.
+
+    Blocks are grouped in size classes of 32 bytes up to 1 KB and never returned to the system.
+    Every thread keeps its own free lists, so allocation and deallocation don't lock. Blocks freed by other threads
+    (e.g. tasks deleted by async workers) move between threads in batches through a shared depot.
+*/
+class WH_DATABASE_API DatabaseObjectPool
+{
+public:
+    static void* Allocate(std::size_t size);
+
+    //! Size must be the one passed to Allocate
+    static void Deallocate(void* ptr, std::size_t size) noexcept;
+
+    static DatabaseObjectPoolStats GetStats();
+};
+
+//! Standard allocator using DatabaseObjectPool, for containers and std::allocate_shared
+template<typename T>
+struct DatabasePoolAllocator
+{
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Pooled blocks have default new alignment");
+
+    using value_type = T;
+
+    DatabasePoolAllocator() = default;
+
+    template<typename U>
+    DatabasePoolAllocator(DatabasePoolAllocator<U> const& /*right*/) noexcept { }
+
+    T* allocate(std::size_t count) { return static_cast<T*>(DatabaseObjectPool::Allocate(count * sizeof(T))); }
+    void deallocate(T* ptr, std::size_t count) noexcept { DatabaseObjectPool::Deallocate(ptr, count * sizeof(T)); }
+
+    template<typename U>
+    bool operator==(DatabasePoolAllocator<U> const& /*right*/) const noexcept { return true; }
+};
+
+#endif
@@ -0,0 +1,213 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "DatabaseReplica.h"
+#include "DatabaseAsyncOperation.h"
+#include "DatabaseAsyncQueue.h"
+#include "Errors.h"
+#include "Log.h"
+#include "MySQLConnection.h"
+#include "QueryResult.h"
+
+namespace
+{
+    class ReplicaHealthCheckOperation : public AsyncOperation
+    {
+    public:
+        explicit ReplicaHealthCheckOperation(DatabaseReplica* replica) :
+            AsyncOperation(), _replica(replica)
+        {
+            SetPriority(QueryPriority::Maintenance);
+        }
+
+        void ExecuteQuery() override
+        {
+            _replica->CheckHealth(_connection);
+        }
+
+    private:
+        DatabaseReplica* _replica;
+    };
+
+    // SHOW REPLICA STATUS replaced SHOW SLAVE STATUS in MySQL 8.0.22 and MariaDB 10.5.1, MySQL 8.4 removed the old one
+    std::string_view GetReplicaStatusQuery(uint32 serverVersion)
+    {
+        bool const isMariaDB = serverVersion >= 100000;
+        bool const hasReplicaStatus = isMariaDB ? serverVersion >= 100501 : serverVersion >= 80022;
+        return hasReplicaStatus ? "SHOW REPLICA STATUS" : "SHOW SLAVE STATUS";
+    }
+}
+
+DatabaseReplica::DatabaseReplica(std::string_view infoString, PreparedStatementRegistry const* registry, QueryStatistics* statistics)
+{
+    _connectionInfo = std::make_unique<MySQLConnectionInfo>(infoString);
+    _queue = std::make_unique<AsyncOperationQueue>();
+    _asyncConnection = std::make_unique<MySQLConnection>(*_connectionInfo, _queue.get());
+    _syncConnection = std::make_unique<MySQLConnection>(*_connectionInfo, nullptr);
+
+    for (auto const& connection : { _asyncConnection.get(), _syncConnection.get() })
+    {
+        connection->SetReplica();
+        connection->SetStatementRegistry(registry);
+        connection->SetStatistics(statistics);
+    }
+}
+
+DatabaseReplica::~DatabaseReplica()
+{
+    _queue->Cancel();
+    _asyncConnection.reset();
+    _syncConnection.reset();
+}
+
+void DatabaseReplica::Open()
+{
+    bool isOpen = !_asyncConnection->Open();
+    isOpen = !_syncConnection->Open() && isOpen;
+
+    // Connections are ready even if not open, health checks run on the async connection and reconnect them
+    _asyncConnection->SetReady();
+    _syncConnection->SetReady();
+
+    if (!isOpen)
+    {
+        LOG_ERROR("db.pool", "Could not open replica {}, reads are executed on the primary", GetHost());
+        return;
+    }
+
+    ScheduleHealthCheck();
+}
+
+void DatabaseReplica::ScheduleHealthCheck()
+{
+    if (_isCheckQueued.exchange(true))
+        return;
+
+    _queue->Push(new ReplicaHealthCheckOperation(this));
+}
+
+void DatabaseReplica::CheckHealth(MySQLConnection* connection)
+{
+    _isCheckQueued = false;
+
+    bool isHealthy = CheckConnection(connection);
+
+    // Busy sync connection is alive
+    if (isHealthy && _syncConnection->LockIfReady())
+    {
+        isHealthy = CheckConnection(_syncConnection.get());
+        _syncConnection->Unlock();
+    }
+
+    std::optional<int64> lag;
+    if (isHealthy)
+        lag = QueryLag(connection);
+
+    isHealthy = isHealthy && lag;
+    _lag = lag.value_or(-1);
+
+    if (_isHealthy.exchange(isHealthy) != isHealthy)
+    {
+        if (isHealthy)
+            LOG_INFO("db.pool", "Replica {} is healthy, lag: {}s", GetHost(), *lag);
+        else
+            LOG_WARN("db.pool", "Replica {} is unhealthy, reads are executed on the primary", GetHost());
+    }
+}
+
+bool DatabaseReplica::IsUsable(Seconds maxLag) const
+{
+    return IsHealthy() && GetLag() <= maxLag.count();
+}
+
+void DatabaseReplica::Enqueue(AsyncOperation* operation)
+{
+    operation->SetEnqueueTime(std::chrono::steady_clock::now());
+    _queue->Push(operation);
+}
+
+MySQLConnection* DatabaseReplica::GetFreeConnection()
+{
+    if (!_syncConnection->LockIfReady())
+        return nullptr;
+
+    if (!_syncConnection->IsConnected())
+    {
+        _syncConnection->Unlock();
+        return nullptr;
+    }
+
+    return _syncConnection.get();
+}
+
+std::string_view DatabaseReplica::GetHost() const
+{
+    return _connectionInfo->Host;
+}
+
+std::size_t DatabaseReplica::GetQueueSize() const
+{
+    return _queue->Size();
+}
+
+/*static*/ bool DatabaseReplica::CheckConnection(MySQLConnection* connection)
+{
+    if (connection->Ping())
+        return true;
+
+    return connection->Reconnect();
+}
+
+std::optional<int64> DatabaseReplica::QueryLag(MySQLConnection* connection)
+{
+    if (!_canReadStatus)
+        return 0;
+
+    auto result = connection->Query(GetReplicaStatusQuery(connection->GetServerVersion()));
+    if (!result)
+    {
+        if (!connection->Ping())
+            return {};
+
+        // Connection is fine, the user lacks REPLICATION CLIENT privilege
+        LOG_WARN("db.pool", "Could not read replication status of replica {}, its lag isn't checked", GetHost());
+        _canReadStatus = false;
+        return 0;
+    }
+
+    // Server isn't replicating, nothing to be behind
+    if (!result->NextRow())
+        return 0;
+
+    for (uint32 i{}; i < result->GetFieldCount(); ++i)
+    {
+        auto const fieldName = result->GetFieldName(i);
+        if (fieldName != "Seconds_Behind_Source" && fieldName != "Seconds_Behind_Master")
+            continue;
+
+        // Replication is stopped
+        if ((*result)[i].IsNull())
+            return {};
+
+        return (*result)[i].Get<int64>();
+    }
+
+    return 0;
+}
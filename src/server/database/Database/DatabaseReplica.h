@@ -0,0 +1,90 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DATABASE_REPLICA_H
+#define _DATABASE_REPLICA_H
+
+#include "DatabaseEnvFwd.h"
+#include "Duration.h"
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+class AsyncOperation;
+class AsyncOperationQueue;
+class PreparedStatementRegistry;
+class QueryStatistics;
+struct MySQLConnectionInfo;
+
+//! Default replication lag above which reads go to the primary
+constexpr Seconds DEFAULT_REPLICA_MAX_LAG = 5s;
+
+/**
+    Read only server of a pool. Statements registered with a ReadOnly connection flag are executed here
+    while the replica is healthy and isn't behind the primary by more than the allowed lag.
+
+    Replica has one async and one sync connection. Health and lag are checked by the async connection,
+    a lost replica isn't fatal, reads fall back to the primary until a health check reconnects it.
+*/
+class WH_DATABASE_API DatabaseReplica
+{
+public:
+    DatabaseReplica(std::string_view infoString, PreparedStatementRegistry const* registry, QueryStatistics* statistics);
+    ~DatabaseReplica();
+
+    //! Replica stays unhealthy if it can't be opened, it's retried by health checks
+    void Open();
+
+    //! Queues a health check to the async connection, does nothing if one is still queued
+    void ScheduleHealthCheck();
+
+    //! Executed by the async connection of the replica
+    void CheckHealth(MySQLConnection* connection);
+
+    [[nodiscard]] bool IsUsable(Seconds maxLag) const;
+
+    void Enqueue(AsyncOperation* operation);
+
+    //! Nullptr if the sync connection is busy, caller must unlock the returned connection
+    MySQLConnection* GetFreeConnection();
+
+    [[nodiscard]] std::string_view GetHost() const;
+    [[nodiscard]] inline bool IsHealthy() const { return _isHealthy.load(std::memory_order_relaxed); }
+
+    //! In seconds, -1 if unknown
+    [[nodiscard]] inline int64 GetLag() const { return _lag.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::size_t GetQueueSize() const;
+
+private:
+    static bool CheckConnection(MySQLConnection* connection);
+    std::optional<int64> QueryLag(MySQLConnection* connection);
+
+    std::unique_ptr<MySQLConnectionInfo> _connectionInfo;
+    std::unique_ptr<AsyncOperationQueue> _queue;
+    std::unique_ptr<MySQLConnection> _asyncConnection;
+    std::unique_ptr<MySQLConnection> _syncConnection;
+    std::atomic<bool> _isHealthy{};
+    std::atomic<int64> _lag{ -1 };
+    std::atomic<bool> _isCheckQueued{};
+    bool _canReadStatus{ true }; ///< False if the user isn't allowed to read replication status, lag isn't checked then
+
+    DatabaseReplica(DatabaseReplica const& right) = delete;
+    DatabaseReplica& operator=(DatabaseReplica const& right) = delete;
+};
+
+#endif
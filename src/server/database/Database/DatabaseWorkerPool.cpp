@@ -16,26 +16,34 @@
  */
 
 #include "DatabaseWorkerPool.h"
+#include "AsyncCompletion.h"
 #include "DatabaseAsyncOperation.h"
+#include "DatabaseAsyncQueue.h"
 #include "DatabaseAsyncQueueWorker.h"
+#include "DatabaseCircuitBreaker.h"
+#include "DatabaseReplica.h"
 #include "Config.h"
 #include "Errors.h"
-#include "FileUtil.h"
 #include "Log.h"
 #include "MySQLConnection.h"
 #include "MySQLPreparedStatement.h"
 #include "MySQLWorkaround.h"
 #include "PCQueue.h"
 #include "PreparedStatement.h"
+#include "PreparedStatementRegistry.h"
 #include "QueryCallback.h"
 #include "QueryHolder.h"
 #include "QueryResult.h"
+#include "QueryResultCache.h"
+#include "QueryStatistics.h"
 #include "TaskScheduler.h"
+#include "Timer.h"
+#include "Tokenize.h"
 #include "Transaction.h"
-#include <filesystem>
-#include <fstream>
+#include <algorithm>
 #include <limits>
 #include <mysqld_error.h>
+#include <thread>
 #include <utility>
 
 #ifdef WARHEAD_DEBUG
@@ -53,12 +61,16 @@
 
 constexpr auto MAX_SYNC_CONNECTIONS = 32;
 constexpr auto MAX_ASYNC_CONNECTIONS = 32;
+constexpr auto FREE_CONNECTION_WAIT_INTERVAL = 10ms;
 
 class PingOperation : public AsyncOperation
 {
 public:
     explicit PingOperation() :
-        AsyncOperation() { }
+        AsyncOperation()
+    {
+        SetPriority(QueryPriority::Maintenance);
+    }
 
     //! Operation for idle delay threads
     void ExecuteQuery() override
@@ -84,13 +96,18 @@ DatabaseWorkerPool::DatabaseWorkerPool(DatabaseType type) :
     ASSERT(isSameClientDB, "Used DB library version ({} id {}) does not match the version id used to compile WarheadCore (id {})", mysql_get_client_info(), mysql_get_client_version(), MYSQL_VERSION_ID);
 
     _scheduler = std::make_unique<TaskScheduler>();
-    _queue = std::make_unique<ProducerConsumerQueue<AsyncOperation*>>();
+    _statementRegistry = std::make_unique<PreparedStatementRegistry>();
+    _resultCache = std::make_unique<QueryResultCache>();
+    _statistics = std::make_unique<QueryStatistics>();
+    _circuitBreaker = std::make_unique<DatabaseCircuitBreaker>();
+    _queue = std::make_unique<AsyncOperationQueue>();
     _asyncQueueCheckQueue = std::make_unique<ProducerConsumerQueue<CheckAsyncQueueTask*>>();
     _asyncQueueChecker = std::make_unique<AsyncDBQueueChecker>(_asyncQueueCheckQueue.get());
 }
 
 DatabaseWorkerPool::~DatabaseWorkerPool()
 {
+    WaitForConnectTasks();
     _scheduler->CancelAll();
     _asyncQueueCheckQueue->Cancel();
     _queue->Cancel();
@@ -99,43 +116,14 @@ DatabaseWorkerPool::~DatabaseWorkerPool()
 void DatabaseWorkerPool::SetConnectionInfo(std::string_view infoString)
 {
     _connectionInfo = std::make_unique<MySQLConnectionInfo>(infoString);
-    MakeExtraFile();
 }
 
-void DatabaseWorkerPool::MakeExtraFile()
+void DatabaseWorkerPool::SetReplicas(std::string_view replicasString)
 {
-    namespace fs = std::filesystem;
-
-    fs::path extraFile(sConfigMgr->GetConfigPath());
-    extraFile /= "DB";
-
-    // Make dir if need
-    ASSERT(Warhead::File::CreateDirIfNeed(extraFile.generic_string()));
-
-    extraFile /= Warhead::StringFormat("{}Config.cnf", GetPoolName());
+    _replicas.clear();
 
-    _pathToExtraFile = extraFile.generic_string();
-
-    try
-    {
-        if (fs::exists(extraFile))
-            return;
-    }
-    catch (const std::error_code& error)
-    {
-        LOG_FATAL("db.pool", "> Error at check '{}'. {}", extraFile.generic_string(), error.message());
-        ABORT();
-    }
-
-    std::ofstream outfile(extraFile.generic_string());
-    if (!outfile.is_open())
-    {
-        LOG_FATAL("db.pool", "Failed to create extra file '{}'", extraFile.generic_string());
-        ABORT();
-    }
-
-    outfile << "[client]\npassword = \"" << _connectionInfo->Password << '"' << std::endl;
-    outfile.close();
+    for (auto infoString : Warhead::Tokenize(replicasString, ',', false))
+        _replicas.emplace_back(std::make_unique<DatabaseReplica>(Warhead::String::TrimLeft(Warhead::String::TrimRight(infoString)), _statementRegistry.get(), _statistics.get()));
 }
 
 uint32 DatabaseWorkerPool::Open()
@@ -144,17 +132,32 @@ uint32 DatabaseWorkerPool::Open()
 
     LOG_INFO("db.pool", "Opening DatabasePool '{}'", GetDatabaseName());
 
-    // Async connection
+    // Both connections wait for the server handshake, open them at once
+    auto asyncOpen = std::async(std::launch::async, [this]()
     {
-        auto [error, connection] = OpenConnection(IDX_ASYNC);
-        if (error)
-            return error;
-    }
+        auto result = OpenConnection(IDX_ASYNC);
+        mysql_thread_end();
+        return result;
+    });
 
-    // Sync connection
     auto [error, connection] = OpenConnection(IDX_SYNCH);
-    if (error)
-        return error;
+    auto [asyncError, asyncConnection] = asyncOpen.get();
+
+    if (asyncError || error)
+    {
+        // Open can be retried, don't keep the connection which was opened
+        std::lock_guard guard(_cleanupMutex);
+        _connections[IDX_ASYNC].clear();
+        _connections[IDX_SYNCH].clear();
+        return asyncError ? asyncError : error;
+    }
+
+    // Default connections are used by updates before statements are prepared
+    asyncConnection->SetReady();
+    connection->SetReady();
+
+    for (auto const& replica : _replicas)
+        replica->Open();
 
     LOG_INFO("db.pool", "DatabasePool '{}' opened successfully", GetDatabaseName());
     LOG_INFO("db.pool", "DB server ver: {}", connection->GetServerInfo());
@@ -165,6 +168,8 @@ uint32 DatabaseWorkerPool::Open()
 
 void DatabaseWorkerPool::Close()
 {
+    WaitForConnectTasks();
+
     if (_connections[IDX_ASYNC].empty() && _connections[IDX_SYNCH].empty())
         return;
 
@@ -173,6 +178,11 @@ void DatabaseWorkerPool::Close()
 
     LOG_INFO("db.pool", "Closing down DatabasePool '{}' ...", GetDatabaseName());
 
+    _replicas.clear();
+
+    // Workers parked until the server is back are joined below
+    _circuitBreaker->Stop();
+
     //! Closes the actually DB connection.
     _connections[IDX_ASYNC].clear();
 
@@ -200,9 +210,53 @@ QueryResult DatabaseWorkerPool::Query(std::string_view sql)
     return { result };
 }
 
+std::vector<QueryResult> DatabaseWorkerPool::QueryMulti(std::vector<std::string_view> const& queries)
+{
+    auto connection = GetFreeConnection();
+    if (!connection)
+        return std::vector<QueryResult>(queries.size());
+
+    auto results = connection->QueryMulti(queries);
+    connection->Unlock();
+
+    // Same semantic as Query, a result points to its first row
+    for (auto& result : results)
+        if (result && !result->NextRow())
+            result.reset();
+
+    return results;
+}
+
+QueryResult DatabaseWorkerPool::QueryStream(std::string_view sql)
+{
+    auto connection = GetFreeConnection();
+    if (!connection)
+        return { nullptr };
+
+    // Result set unlocks the connection when it's drained or destroyed
+    auto result = connection->QueryStream(sql);
+    if (!result)
+    {
+        connection->Unlock();
+        return { nullptr };
+    }
+
+    if (!result->NextRow())
+        return { nullptr };
+
+    return { result };
+}
+
 std::pair<uint32, MySQLConnection*> DatabaseWorkerPool::OpenConnection(InternalIndex type, bool isDynamic /*= false*/)
 {
     auto connection = std::make_unique<MySQLConnection>(*_connectionInfo, type == IDX_ASYNC ? _queue.get() : nullptr, isDynamic);
+
+    // Async worker of the connection is started by SetReady
+    connection->SetStatementRegistry(_statementRegistry.get());
+    connection->SetResultCache(_resultCache.get());
+    connection->SetStatistics(_statistics.get());
+    connection->SetCircuitBreaker(_circuitBreaker.get());
+
     if (uint32 error = connection->Open())
     {
         // Failed to open a connection or invalid version
@@ -214,8 +268,14 @@ std::pair<uint32, MySQLConnection*> DatabaseWorkerPool::OpenConnection(InternalI
         return { 1, nullptr };
     }
 
+    // Connection isn't used by other threads until it's ready
+    std::lock_guard guard(_cleanupMutex);
     auto& itrConnection = _connections[type].emplace_back(std::move(connection));
 
+    // Sync callers waiting for a free connection are woken up when it's unlocked
+    if (type == IDX_SYNCH)
+        itrConnection->SetFreeCondition(&_connectionFreed);
+
     // Everything is fine
     return { 0, itrConnection.get() };
 }
@@ -231,36 +291,48 @@ MySQLConnection* DatabaseWorkerPool::GetFreeConnection()
     }
 #endif
 
-    std::lock_guard guardCleanup(_cleanupMutex);
-
-    // Check default connections
-    for (auto& connection : _connections[IDX_SYNCH])
-        if (connection->LockIfReady())
-            return connection.get();
-
-    LOG_WARN("db.pool", "> Not found free sync connection. Connections count: {}", _connections[IDX_SYNCH].size());
-
-    // Try to make new connect if connections count < MAX_SYNC_CONNECTIONS
-    OpenDynamicSyncConnect();
+    MySQLConnection* connection = LockFreeConnection();
 
-    std::lock_guard guardOpenConnect(_openSyncConnectMutex);
+    // Not under the cleanup mutex, probing the lost server can take the connect timeout.
+    // Sync callers aren't parked, they fail at once until the server is back.
+    if (!connection->IsConnected() && !connection->WaitForReconnect(std::chrono::steady_clock::now()))
+    {
+        connection->Unlock();
+        return nullptr;
+    }
 
-    MySQLConnection* freeConnection{ nullptr };
+    return connection;
+}
 
-    uint8 i{};
-    auto const num_cons{ _connections[IDX_SYNCH].size()};
+MySQLConnection* DatabaseWorkerPool::LockFreeConnection()
+{
+    std::unique_lock guardCleanup(_cleanupMutex);
+    bool connectRequested{};
 
-    //! Block forever until a connection is free
+    //! Block until a connection is free
     for (;;)
     {
-        freeConnection = _connections[IDX_SYNCH][++i % num_cons].get();
+        // The list is read on every pass, dynamic connections are added while waiting
+        for (auto& connection : _connections[IDX_SYNCH])
+        {
+            //! Must be matched with t->Unlock() or you will get deadlocks
+            if (connection->LockIfReady())
+                return connection.get();
+        }
 
-        //! Must be matched with t->Unlock() or you will get deadlocks
-        if (freeConnection->LockIfReady())
-            break;
-    }
+        if (!connectRequested)
+        {
+            LOG_WARN("db.pool", "> Not found free sync connection. Connections count: {}", _connections[IDX_SYNCH].size());
+
+            // Try to make new connect if connections count < MAX_SYNC_CONNECTIONS.
+            // It's opened in background and needs the cleanup lock to be added.
+            OpenDynamicSyncConnect();
+            connectRequested = true;
+        }
 
-    return freeConnection;
+        // Lock is released while waiting. Unlock doesn't take the cleanup lock, a missed notify only costs the timeout.
+        _connectionFreed.wait_for(guardCleanup, FREE_CONNECTION_WAIT_INTERVAL);
+    }
 }
 
 std::string_view DatabaseWorkerPool::GetDatabaseName() const
@@ -276,7 +348,7 @@ void DatabaseWorkerPool::Execute(std::string_view sql)
     Enqueue(new BasicStatementTask(sql));
 }
 
-void DatabaseWorkerPool::Execute(PreparedStatement stmt)
+void DatabaseWorkerPool::Execute(PreparedStatement stmt, QueryPriority priority /*= QueryPriority::Background*/)
 {
     if (!stmt)
         return;
@@ -288,7 +360,32 @@ void DatabaseWorkerPool::Execute(PreparedStatement stmt)
         return;
     }
 
-    Enqueue(new PreparedStatementTask(std::move(stmt)));
+    // Reads enqueued after this write must not get the old rows, the connection invalidates again when it's done
+    _resultCache->Invalidate(*stmt);
+
+    auto task = new PreparedStatementTask(std::move(stmt));
+    task->SetPriority(priority);
+    Enqueue(task);
+}
+
+void DatabaseWorkerPool::EnableResultCache(uint32 index, Milliseconds ttl, uint8 partitionParams /*= 0*/)
+{
+    _resultCache->EnableStatement(index, ttl, partitionParams);
+}
+
+void DatabaseWorkerPool::AddResultCacheInvalidation(uint32 writeIndex, uint32 readIndex, std::vector<uint8> writeParams /*= {}*/)
+{
+    _resultCache->AddInvalidation(writeIndex, readIndex, std::move(writeParams));
+}
+
+void DatabaseWorkerPool::InvalidateResultCache(Transaction& transaction)
+{
+    if (!_resultCache->IsEnabled())
+        return;
+
+    for (auto const& data : *transaction.GetQueries())
+        if (data.type == SQL_ELEMENT_PREPARED)
+            _resultCache->Invalidate(*std::get<PreparedStatement>(data.element));
 }
 
 void DatabaseWorkerPool::CleanupConnections()
@@ -311,80 +408,74 @@ bool DatabaseWorkerPool::PrepareStatements()
     // Init all prepare statements
     DoPrepareStatements();
 
-    for (auto const& connections : _connections)
-    {
-        for (auto const& connection : connections)
-        {
-            connection->GetPreparedStatementList()->resize(GetStatementSize());
-
-            for (auto const& [index, stmt] : _stringPreparedStatement)
-                connection->PrepareStatement(index, stmt.Query, stmt.ConnectionType);
-        }
-    }
+    _statementRegistry->Resize(GetStatementSize());
+    _statistics->SetStatementCount(uint32(_statementRegistry->GetSize()));
 
-    auto IsValidPrepareStatements = [this](MySQLConnection* connection)
-    {
-        if (!connection->LockIfReady())
-            return false;
+    // Each statement is validated once, on a default connection it can be executed on.
+    // Handle is kept by that connection, other connections prepare the statement on first use.
+    std::array<std::vector<uint32>, IDX_SIZE> validateIndexes;
 
-        if (!connection->PrepareStatements())
-        {
-            connection->Unlock();
-            Close();
-            return false;
-        }
-        else
-            connection->Unlock();
+    for (uint32 index{}; index < _statementRegistry->GetSize(); ++index)
+        if (auto info = _statementRegistry->GetInfo(index))
+            validateIndexes[((uint8)info->ConnectionType & (uint8)ConnectionFlags::Sync) ? IDX_SYNCH : IDX_ASYNC].emplace_back(index);
 
-        auto list = connection->GetPreparedStatementList();
-        auto const preparedSize = list->size();
+    // Every statement is a round trip to the server, connections validate them at once
+    std::vector<std::future<bool>> validating;
 
-        if (_preparedStatementSize.size() < preparedSize)
-            _preparedStatementSize.resize(preparedSize);
+    for (uint8 type{}; type < IDX_SIZE; ++type)
+    {
+        if (validateIndexes[type].empty())
+            continue;
 
-        for (uint32 i = 0; i < preparedSize; ++i)
+        validating.emplace_back(std::async(std::launch::async, [this, connection = _connections[type].front().get(), &indexes = validateIndexes[type]]()
         {
-            // already set by another connection
-            // (each connection only has prepared statements of its own type sync/async)
-            if (_preparedStatementSize[i] > 0)
-                continue;
+            bool isValid{ true };
 
-            if (auto stmt = (*list)[i].get())
+            for (uint32 index : indexes)
             {
+                auto stmt = connection->GetPreparedStatement(index);
+                if (!stmt)
+                {
+                    isValid = false;
+                    continue;
+                }
+
                 uint32 const paramCount = stmt->GetParameterCount();
 
                 // WH only supports uint8 indices.
                 ASSERT(paramCount < std::numeric_limits<uint8>::max());
-                _preparedStatementSize[i] = static_cast<uint8>(paramCount);
+                _statementRegistry->SetParamCount(index, static_cast<uint8>(paramCount));
             }
-        }
 
-        return true;
-    };
+            mysql_thread_end();
+            return isValid;
+        }));
+    }
+
+    bool isPrepared{ true };
 
-    for (auto const& connections : _connections)
-        for (auto const& connection : connections)
-            if (!IsValidPrepareStatements(connection.get()))
-                return false;
+    for (auto& result : validating)
+        if (!result.get())
+            isPrepared = false;
+
+    if (!isPrepared)
+    {
+        Close();
+        return false;
+    }
 
     return true;
 }
 
 PreparedStatement DatabaseWorkerPool::GetPreparedStatement(uint32 index)
 {
-    return std::make_shared<PreparedStatementBase>(index, _preparedStatementSize[index]);
+    return std::allocate_shared<PreparedStatementBase>(DatabasePoolAllocator<PreparedStatementBase>(), index, _statementRegistry->GetParamCount(index));
 }
 
-void DatabaseWorkerPool::PrepareStatement(uint32 index, std::string_view sql, ConnectionFlags flags)
+void DatabaseWorkerPool::PrepareStatement(uint32 index, std::string_view sql, ConnectionFlags flags, std::optional<uint8> paramCount /*= {}*/)
 {
-    auto const& itr = _stringPreparedStatement.find(index);
-    if (itr != _stringPreparedStatement.end())
-    {
-        LOG_ERROR("db.pool", "{} DBPool: Trying add exist statement with index ()! Skip", GetPoolName(), index);
-        return;
-    }
-
-    _stringPreparedStatement.emplace(index, StringPreparedStatement{ index, sql, flags });
+    if (!_statementRegistry->Register(index, sql, flags, paramCount))
+        LOG_ERROR("db.pool", "{} DBPool: Trying add exist statement with index {}! Skip", GetPoolName(), index);
 }
 
 PreparedQueryResult DatabaseWorkerPool::Query(PreparedStatement stmt)
@@ -396,41 +487,133 @@ PreparedQueryResult DatabaseWorkerPool::Query(PreparedStatement stmt)
         return { nullptr };
     }
 
+    std::string cacheKey;
+
+    if (_resultCache->IsEnabled(stmt->GetIndex()))
+    {
+        cacheKey = _resultCache->MakeKey(*stmt);
+
+        if (auto data = _resultCache->Get(cacheKey))
+        {
+            if (!data->RowCount)
+                return { nullptr };
+
+            return std::make_shared<PreparedResultSet>(std::move(data));
+        }
+    }
+
+    if (auto replica = GetReplica(stmt->GetIndex()))
+    {
+        if (auto connection = replica->GetFreeConnection())
+        {
+            auto result = connection->Query(stmt);
+            connection->Unlock();
+
+            // Replica can be behind the write which invalidated the cached result, don't store it.
+            // Query failed on the replica if there is no result, it's executed on the primary then.
+            if (result)
+                return result->GetRowCount() ? result : nullptr;
+        }
+    }
+
     auto connection = GetFreeConnection();
     if (!connection)
         return { nullptr };
 
+    uint64 cacheGeneration = _resultCache->GetGeneration();
+
     auto result = connection->Query(std::move(stmt));
     connection->Unlock();
 
+    if (!cacheKey.empty())
+        _resultCache->Store(std::move(cacheKey), result.get(), cacheGeneration);
+
     if (!result || !result->GetRowCount())
         return { nullptr };
 
     return { result };
 }
 
-void DatabaseWorkerPool::InitPrepareStatement(MySQLConnection* connection)
+PreparedQueryResult DatabaseWorkerPool::QueryStream(PreparedStatement stmt, uint32 prefetchRows /*= DEFAULT_STREAM_PREFETCH_ROWS*/)
 {
-    connection->GetPreparedStatementList()->resize(GetStatementSize());
+    auto [isAllSet, notSetIndex] = stmt->IsAllParamsSet();
+    if (!isAllSet)
+    {
+        LOG_ERROR("db.pool", "{} DBPool: Trying to query incorrect stmt. Index: {}. Incorrect param index: {}", GetPoolName(), stmt->GetIndex(), notSetIndex);
+        return { nullptr };
+    }
+
+    auto connection = GetFreeConnection();
+    if (!connection)
+        return { nullptr };
 
-    for (auto const& [index, stmt] : _stringPreparedStatement)
-        connection->PrepareStatement(index, stmt.Query, stmt.ConnectionType);
+    // Result set unlocks the connection when it's drained or destroyed
+    auto result = connection->QueryStream(std::move(stmt), prefetchRows);
+    if (!result)
+    {
+        connection->Unlock();
+        return { nullptr };
+    }
+
+    // Fetch the first row to keep the same semantic as buffered results
+    if (!result->NextRow())
+        return { nullptr };
+
+    return { result };
 }
 
-QueryCallback DatabaseWorkerPool::AsyncQuery(std::string_view sql)
+QueryCallback DatabaseWorkerPool::AsyncQuery(std::string_view sql, Milliseconds timeout /*= 0ms*/, QueryPriority priority /*= QueryPriority::Interactive*/)
 {
     auto task = new BasicStatementTask(sql, true);
-    auto result = task->GetFuture();
+    AsyncCompletionPtr completion = task->GetCompletion();
+    task->SetPriority(priority);
+
+    if (timeout > 0ms)
+        task->SetDeadline(std::chrono::steady_clock::now() + timeout);
+
     Enqueue(task);
-    return QueryCallback(std::move(result));
+    return QueryCallback(std::move(completion));
 }
 
-QueryCallback DatabaseWorkerPool::AsyncQuery(PreparedStatement stmt)
+QueryCallback DatabaseWorkerPool::AsyncQuery(PreparedStatement stmt, Milliseconds timeout /*= 0ms*/, QueryPriority priority /*= QueryPriority::Interactive*/)
 {
+    std::string cacheKey;
+
+    if (_resultCache->IsEnabled(stmt->GetIndex()))
+    {
+        cacheKey = _resultCache->MakeKey(*stmt);
+
+        if (auto data = _resultCache->Get(cacheKey))
+        {
+            // Callback is invoked on the next processor update, without a round trip to the server
+            auto completion = AsyncCompletion::Create(true);
+            completion->SetResult(data->RowCount ? std::make_shared<PreparedResultSet>(std::move(data)) : nullptr);
+            completion->Complete();
+            return QueryCallback(std::move(completion));
+        }
+    }
+
+    auto replica = GetReplica(stmt->GetIndex());
     auto task = new PreparedStatementTask(std::move(stmt), true);
-    auto result = task->GetFuture();
+    AsyncCompletionPtr completion = task->GetCompletion();
+    task->SetPriority(priority);
+
+    if (timeout > 0ms)
+        task->SetDeadline(std::chrono::steady_clock::now() + timeout);
+
+    // Results of a replica aren't cached, see Query
+    if (replica)
+    {
+        task->SetFallback(this);
+        replica->Enqueue(task);
+        return QueryCallback(std::move(completion));
+    }
+
+    if (!cacheKey.empty())
+        task->SetResultCache(_resultCache.get(), std::move(cacheKey));
+
     Enqueue(task);
-    return QueryCallback(std::move(result));
+    return QueryCallback(std::move(completion));
 }
 
 SQLTransaction DatabaseWorkerPool::BeginTransaction()
@@ -457,6 +640,8 @@ void DatabaseWorkerPool::CommitTransaction(SQLTransaction transaction)
     }
 #endif // WARHEAD_DEBUG
 
+    InvalidateResultCache(*transaction);
+
     Enqueue(new TransactionTask(std::move(transaction)));
 }
 
@@ -479,6 +664,8 @@ TransactionCallback DatabaseWorkerPool::AsyncCommitTransaction(SQLTransaction tr
     }
 #endif // WARHEAD_DEBUG
 
+    InvalidateResultCache(*transaction);
+
     auto task = new TransactionWithResultTask(std::move(transaction));
     TransactionFuture result = task->GetFuture();
     Enqueue(task);
@@ -487,12 +674,19 @@ TransactionCallback DatabaseWorkerPool::AsyncCommitTransaction(SQLTransaction tr
 
 void DatabaseWorkerPool::Enqueue(AsyncOperation* operation)
 {
+    operation->SetEnqueueTime(std::chrono::steady_clock::now());
     _queue->Push(operation);
 }
 
 void DatabaseWorkerPool::DirectCommitTransaction(SQLTransaction transaction)
 {
     auto connection = GetFreeConnection();
+    if (!connection)
+    {
+        LOG_ERROR("db.pool", "{} DBPool: Server is unreachable, transaction is not executed", GetPoolName());
+        transaction->Cleanup();
+        return;
+    }
 
     auto errorCode = connection->ExecuteTransaction(transaction);
     if (!errorCode)
@@ -502,17 +696,22 @@ void DatabaseWorkerPool::DirectCommitTransaction(SQLTransaction transaction)
     }
 
     //! Handle MySQL Errno 1213 without extending deadlock to the core itself
-    /// @todo More elegant way
-    if (errorCode == ER_LOCK_DEADLOCK)
+    for (uint32 retries = 0; errorCode == ER_LOCK_DEADLOCK && retries < TransactionTask::GetMaxDeadlockRetries(); ++retries)
     {
-        //todo: handle multiple sync threads deadlocking in a similar way as async threads
-        uint8 loopBreaker = 5;
+        std::this_thread::sleep_for(GetBackoffDelay(retries, DEADLOCK_RETRY_MIN_DELAY, DEADLOCK_RETRY_MAX_DELAY));
+        errorCode = connection->ExecuteTransaction(transaction);
+    }
 
-        for (uint8 i = 0; i < loopBreaker; ++i)
-        {
-            if (!connection->ExecuteTransaction(transaction))
-                break;
-        }
+    if (!errorCode)
+    {
+        connection->Unlock();
+        return;
+    }
+
+    if (errorCode == ER_LOCK_DEADLOCK)
+    {
+        LOG_ERROR("db.query", "Fatal deadlocked SQL Transaction, it will not be retried anymore");
+        _statistics->RecordDeadlockFailure();
     }
 
     //! Clean up now.
@@ -542,6 +741,9 @@ void DatabaseWorkerPool::DirectExecute(std::string_view sql)
         return;
 
     auto connection = GetFreeConnection();
+    if (!connection)
+        return;
+
     connection->Execute(sql);
     connection->Unlock();
 }
@@ -549,19 +751,27 @@ void DatabaseWorkerPool::DirectExecute(std::string_view sql)
 void DatabaseWorkerPool::DirectExecute(PreparedStatement stmt)
 {
     auto connection = GetFreeConnection();
+    if (!connection)
+        return;
+
     connection->Execute(std::move(stmt));
     connection->Unlock();
 }
 
-void DatabaseWorkerPool::EscapeString(std::string& str)
+bool DatabaseWorkerPool::DirectExecuteScript(std::vector<std::string_view> const& statements)
 {
-    if (str.empty())
-        return;
+    // Session state set by the script (SET FOREIGN_KEY_CHECKS, sql_mode, USE, variables) ends with the connection,
+    // as it does with the mysql client. Connections of the pool are set up by Open only.
+    MySQLConnection connection(*_connectionInfo, nullptr);
+    if (connection.Open())
+        return false;
+
+    return connection.ExecuteScript(statements);
+}
 
-    char* buf = new char[str.size() * 2 + 1];
-    EscapeString(buf, str.c_str(), uint32(str.size()));
-    str = buf;
-    delete[] buf;
+void DatabaseWorkerPool::EscapeString(std::string& str)
+{
+    EscapeSQLString(str);
 }
 
 void DatabaseWorkerPool::KeepAlive()
@@ -585,18 +795,43 @@ std::size_t DatabaseWorkerPool::GetQueueSize() const
     return _queue->Size();
 }
 
-unsigned long DatabaseWorkerPool::EscapeString(char* to, char const* from, unsigned long length)
+std::size_t DatabaseWorkerPool::GetQueueSize(QueryPriority priority) const
 {
-    if (!to || !from || !length)
-        return 0;
-
-    return _connections[IDX_SYNCH].front()->EscapeString(to, from, length);
+    return _queue->Size(priority);
 }
 
-SQLQueryHolderCallback DatabaseWorkerPool::DelayQueryHolder(SQLQueryHolder holder)
+SQLQueryHolderCallback DatabaseWorkerPool::DelayQueryHolder(SQLQueryHolder holder, bool parallel /*= false*/)
 {
+    std::size_t connectionCount{};
+
+    if (parallel)
+    {
+        std::lock_guard guard(_cleanupMutex);
+        connectionCount = _connections[IDX_ASYNC].size();
+    }
+
+    // One part per connection, idle workers take them at once and the holder completes after its slowest query
+    std::size_t const parts = std::min(connectionCount, holder->GetSize());
+    if (parts > 1)
+    {
+        auto latch = std::make_shared<SQLQueryHolderLatch>(static_cast<uint32>(parts));
+        QueryResultHolderFuture result = latch->Result.get_future();
+
+        for (std::size_t part{}; part < parts; ++part)
+        {
+            auto task = new SQLQueryHolderTask(holder, latch, holder->GetSize() * part / parts, holder->GetSize() * (part + 1) / parts);
+            task->SetPriority(QueryPriority::Interactive);
+            Enqueue(task);
+        }
+
+        return { std::move(holder), std::move(result) };
+    }
+
     auto task = new SQLQueryHolderTask(holder);
     QueryResultHolderFuture result = task->GetFuture();
+
+    // Results are waited for like the ones of AsyncQuery
+    task->SetPriority(QueryPriority::Interactive);
     Enqueue(task);
     return { std::move(holder), std::move(result) };
 }
@@ -622,6 +857,43 @@ void DatabaseWorkerPool::AddTasks()
         context.Repeat();
     });
 
+    // Read replicas
+    _replicaMaxLag = Seconds{ sConfigMgr->GetOption<uint32>("Database.Replica.MaxLag", uint32(DEFAULT_REPLICA_MAX_LAG.count())) };
+
+    if (!_replicas.empty())
+    {
+        _scheduler->Schedule(Seconds{ sConfigMgr->GetOption<uint32>("Database.Replica.CheckInterval", 5) }, [this](TaskContext context)
+        {
+            for (auto const& replica : _replicas)
+                replica->ScheduleHealthCheck();
+
+            context.Repeat();
+        });
+    }
+
+    // Reconnect of lost connections
+    _circuitBreaker->SetReconnectDelays(Milliseconds{ sConfigMgr->GetOption<uint32>("Database.Reconnect.MinDelay", uint32(DEFAULT_RECONNECT_MIN_DELAY.count())) },
+        Milliseconds{ sConfigMgr->GetOption<uint32>("Database.Reconnect.MaxDelay", uint32(DEFAULT_RECONNECT_MAX_DELAY.count())) });
+    _circuitBreaker->SetParkTimeout(Milliseconds{ sConfigMgr->GetOption<uint32>("Database.Reconnect.ParkTimeout", uint32(DEFAULT_RECONNECT_PARK_TIMEOUT.count())) });
+
+    _statementRegistry->SetMaxStatementsPerConnection(sConfigMgr->GetOption<uint32>("Database.MaxPreparedStatements", 0));
+    _statistics->SetSlowQueryThreshold(Milliseconds{ sConfigMgr->GetOption<uint32>("Database.SlowQueryThreshold", uint32(DEFAULT_SLOW_QUERY_THRESHOLD.count())) });
+
+    TransactionTask::SetMaxDeadlockRetries(sConfigMgr->GetOption<uint32>("Database.Deadlock.MaxRetries", DEFAULT_DEADLOCK_MAX_RETRIES));
+
+    // Group commit of one-way writes
+    _queue->SetGroupCommit(sConfigMgr->GetOption<uint32>("Database.GroupCommit.MaxWrites", 0),
+        Milliseconds{ sConfigMgr->GetOption<uint32>("Database.GroupCommit.Window", 2) });
+
+    // Result cache
+    _resultCache->SetMaxSize(std::size_t(sConfigMgr->GetOption<uint32>("ResultCache.MaxSize", DEFAULT_RESULT_CACHE_SIZE / 1024)) * 1024);
+
+    _scheduler->Schedule(1min, [this](TaskContext context)
+    {
+        _resultCache->PurgeExpired();
+        context.Repeat();
+    });
+
     // Cleanup dynamic connections
     _scheduler->Schedule(10s, [this](TaskContext context)
     {
@@ -639,42 +911,160 @@ void DatabaseWorkerPool::AddTasks()
 
 void DatabaseWorkerPool::OpenDynamicAsyncConnect()
 {
-    std::lock_guard guard(_openAsyncConnectMutex);
+    OpenDynamicConnect(IDX_ASYNC);
+}
 
-    if (_connections[IDX_ASYNC].size() >= MAX_ASYNC_CONNECTIONS)
-        return;
+void DatabaseWorkerPool::OpenDynamicSyncConnect()
+{
+    OpenDynamicConnect(IDX_SYNCH);
+}
 
-    LOG_DEBUG("db.pool", "Add new dynamic async connection...");
+void DatabaseWorkerPool::OpenDynamicConnect(InternalIndex type)
+{
+    std::lock_guard guard(_connectTasksMutex);
 
-    auto [error, connection] = OpenConnection(IDX_ASYNC, true);
-    if (error)
+    // Connections being opened are counted too, callers not finding a free connection don't open more than allowed
+    std::size_t const maxConnections = type == IDX_ASYNC ? MAX_ASYNC_CONNECTIONS : MAX_SYNC_CONNECTIONS;
+    if (_connections[type].size() + _pendingConnections[type] >= maxConnections)
         return;
 
-    InitPrepareStatement(connection);
-    ASSERT(connection->PrepareStatements(), "Can't register prepare statements for dynamic async connection");
+    // Connect would fail, busy connections are waiting for the server too
+    if (!_circuitBreaker->IsClosed())
+        return;
+
+    LOG_DEBUG("db.pool", "Add new dynamic {} connection...", type == IDX_ASYNC ? "async" : "sync");
+
+    std::erase_if(_connectTasks, [](std::future<void> const& task)
+    {
+        return task.wait_for(0s) == std::future_status::ready;
+    });
+
+    ++_pendingConnections[type];
+
+    _connectTasks.emplace_back(std::async(std::launch::async, [this, type]()
+    {
+        auto [error, connection] = OpenConnection(type, true);
+        --_pendingConnections[type];
+
+        // Statements are prepared on first use
+        if (!error)
+        {
+            connection->SetReady();
+
+            if (type == IDX_SYNCH)
+                _connectionFreed.notify_all();
+        }
+
+        mysql_thread_end();
+    }));
 }
 
-void DatabaseWorkerPool::OpenDynamicSyncConnect()
+void DatabaseWorkerPool::WaitForConnectTasks()
 {
-    std::lock_guard guard(_openSyncConnectMutex);
+    std::vector<std::future<void>> tasks;
 
-    if (_connections[IDX_SYNCH].size() >= MAX_SYNC_CONNECTIONS)
-        return;
+    {
+        std::lock_guard guard(_connectTasksMutex);
+        tasks.swap(_connectTasks);
+    }
+
+    // Not under the lock, tasks add connections under the cleanup mutex and its holder can open a connection
+    for (auto& task : tasks)
+        task.wait();
+}
+
+DatabaseReplica* DatabaseWorkerPool::GetReplica(uint32 index)
+{
+    if (_replicas.empty())
+        return nullptr;
 
-    LOG_DEBUG("db.pool", "Add new dynamic sync connection...");
+    auto stmtInfo = _statementRegistry->GetInfo(index);
+    if (!stmtInfo || !((uint8)stmtInfo->ConnectionType & (uint8)ConnectionFlags::ReadOnly))
+        return nullptr;
 
-    auto [error, connection] = OpenConnection(IDX_SYNCH, true);
-    if (!error)
+    // Round robin, replicas which are down or too far behind are skipped
+    uint32 const start = _nextReplica.fetch_add(1, std::memory_order_relaxed);
+
+    for (std::size_t i{}; i < _replicas.size(); ++i)
     {
-        InitPrepareStatement(connection);
-        ASSERT(connection->PrepareStatements());
+        auto& replica = _replicas[(start + i) % _replicas.size()];
+        if (replica->IsUsable(_replicaMaxLag))
+            return replica.get();
     }
+
+    return nullptr;
 }
 
 void DatabaseWorkerPool::GetPoolInfo(std::function<void(std::string_view)> const& info)
 {
     info(Warhead::StringFormat("Pool name: {}. Connections count (sync/async): {}/{}", GetPoolName(), _connections[IDX_SYNCH].size(), _connections[IDX_ASYNC].size()));
-    info(Warhead::StringFormat("Queue size: {}. Max size: {}", GetQueueSize(), _maxAsyncQueueSize));
+    info(Warhead::StringFormat("Queue size: {} (interactive/background/maintenance: {}/{}/{}). Max size: {}", GetQueueSize(),
+        GetQueueSize(QueryPriority::Interactive), GetQueueSize(QueryPriority::Background), GetQueueSize(QueryPriority::Maintenance), _maxAsyncQueueSize));
+
+    if (!_circuitBreaker->IsClosed())
+        info(Warhead::StringFormat("Server is unreachable. Failed reconnect attempts: {}", _circuitBreaker->GetFailedProbes()));
+
+    for (auto const& replica : _replicas)
+        info(Warhead::StringFormat("Replica {}: {}. Lag: {}s. Queue size: {}", replica->GetHost(), replica->IsHealthy() ? "healthy" : "unhealthy", replica->GetLag(), replica->GetQueueSize()));
+
+    {
+        std::lock_guard guard(_cleanupMutex);
+        uint32 preparedCount{};
+
+        for (auto const& connections : _connections)
+            for (auto const& connection : connections)
+                preparedCount += connection->GetPreparedStatementCount();
+
+        info(Warhead::StringFormat("Prepared statements: {} registered, {} prepared on server", _statementRegistry->GetRegisteredCount(), preparedCount));
+    }
+
+    if (_resultCache->IsEnabled())
+    {
+        auto const& stats = _resultCache->GetStats();
+        info(Warhead::StringFormat("Result cache: {} entries, {}/{} KB. Hits/misses: {}/{}. Evictions: {}. Invalidations: {}",
+            stats.Entries, stats.Size / 1024, stats.MaxSize / 1024, stats.Hits, stats.Misses, stats.Evictions, stats.Invalidations));
+    }
+
+    QueryStatisticsInfo queueWait;
+    _statistics->GetQueueWaitInfo(queueWait);
+    info(Warhead::StringFormat("Queue wait of {} async operations. p50/p99/max: {}/{}/{}. Dropped (cancelled or expired): {}", queueWait.Calls,
+        Warhead::Time::ToTimeString(queueWait.P50), Warhead::Time::ToTimeString(queueWait.P99), Warhead::Time::ToTimeString(queueWait.Max), _statistics->GetDroppedCount()));
+
+    auto deadlocks = _statistics->GetDeadlockInfo();
+    if (!deadlocks.empty() || _statistics->GetDeadlockFailureCount())
+    {
+        info(Warhead::StringFormat("Deadlocks: {} transactions failed after all retries", _statistics->GetDeadlockFailureCount()));
+
+        for (auto const& [table, count] : deadlocks)
+            info(Warhead::StringFormat("> Table `{}`: {} deadlocks", table, count));
+    }
+
+    if (_queue->IsGroupCommitEnabled())
+        info(Warhead::StringFormat("Group commit: {} writes in {} transactions", _statistics->GetGroupedWriteCount(), _statistics->GetGroupCommitCount()));
+
+    auto ShowStatementInfo = [&info](std::string_view name, QueryStatisticsInfo const& stats)
+    {
+        info(Warhead::StringFormat("> {}. Calls: {}. Errors: {}. Rows: {}. p50/p99/max: {}/{}/{}", name, stats.Calls, stats.Errors, stats.Rows,
+            Warhead::Time::ToTimeString(stats.P50), Warhead::Time::ToTimeString(stats.P99), Warhead::Time::ToTimeString(stats.Max)));
+    };
+
+    QueryStatisticsInfo statementInfo;
+
+    for (uint32 index{}; index < _statistics->GetStatementCount(); ++index)
+    {
+        if (!_statistics->GetInfo(index, statementInfo))
+            continue;
+
+        auto stmtInfo = _statementRegistry->GetInfo(index);
+        ShowStatementInfo(Warhead::StringFormat("Statement {} ({})", index, stmtInfo ? std::string_view(stmtInfo->Query) : "unknown"), statementInfo);
+    }
+
+    if (_statistics->GetInfo(QueryStatistics::STRING_QUERY_INDEX, statementInfo))
+        ShowStatementInfo("String queries", statementInfo);
+
+    // Shared by all pools
+    auto const& poolStats = DatabaseObjectPool::GetStats();
+    info(Warhead::StringFormat("Object pool hits/misses: {}/{}. Oversized: {}", poolStats.Hits, poolStats.Misses, poolStats.Oversized));
 }
 
 void DatabaseWorkerPool::CheckAsyncQueue()
@@ -19,13 +19,18 @@
 #define _DATABASEWORKERPOOL_H
 
 #include "DatabaseEnvFwd.h"
+#include "DatabaseObjectPool.h"
 #include "Duration.h"
+#include "QueryBuilder.h"
 #include "StringFormat.h"
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <future>
 #include <mutex>
+#include <optional>
 #include <thread>
-#include <unordered_map>
 #include <vector>
 
 template <typename T>
@@ -33,18 +38,20 @@ class ProducerConsumerQueue;
 
 class AsyncDBQueueChecker;
 class AsyncOperation;
+class AsyncOperationQueue;
 class CheckAsyncQueueTask;
+class DatabaseCircuitBreaker;
+class DatabaseReplica;
+class PreparedStatementRegistry;
+class QueryResultCache;
+class QueryStatistics;
 class TaskScheduler;
 
-struct StringPreparedStatement
-{
-    StringPreparedStatement(uint32 index, std::string_view sql, ConnectionFlags flags) :
-        Index(index), Query(sql), ConnectionType(flags) { }
+template<typename S>
+class TypedPreparedStatement;
 
-    uint32 Index{};
-    std::string Query;
-    ConnectionFlags ConnectionType{ ConnectionFlags::Sync };
-};
+//! Default count of rows sent by the server per fetch for streamed prepared queries
+constexpr uint32 DEFAULT_STREAM_PREFETCH_ROWS = 256;
 
 class WH_DATABASE_API DatabaseWorkerPool
 {
@@ -62,10 +69,13 @@ public:
 
     void SetConnectionInfo(std::string_view infoString);
 
+    //! Connection strings of read replicas separated by ',', opened with the pool
+    void SetReplicas(std::string_view replicasString);
+
     uint32 Open();
     void Close();
 
-    //! Prepares all prepared statements
+    //! Registers all prepared statements and validates them against the server, connections prepare them on first use
     bool PrepareStatements();
     virtual void DoPrepareStatements() = 0;
 
@@ -89,10 +99,12 @@ public:
         if (sql.empty())
             return;
 
-        Execute(Warhead::StringFormat(sql, std::forward<Args>(args)...));
+        Execute(QueryBuilder::Format(sql, std::forward<Args>(args)...));
     }
 
-    void Execute(PreparedStatement stmt);
+    //! Enqueues a one-way SQL operation in prepared format that will be executed asynchronously.
+    //! Operations of different priorities can be executed out of order, use a transaction if a write must be done before a read.
+    void Execute(PreparedStatement stmt, QueryPriority priority = QueryPriority::Background);
 
     /**
         Direct synchronous one-way statement methods.
@@ -110,13 +122,17 @@ public:
         if (sql.empty())
             return;
 
-        DirectExecute(Warhead::StringFormat(sql, std::forward<Args>(args)...));
+        DirectExecute(QueryBuilder::Format(sql, std::forward<Args>(args)...));
     }
 
     //! Directly executes a one-way SQL operation in prepared statement format, that will block the calling thread until finished.
     //! Statement must be prepared with the CONNECTION_SYNCH flag.
     void DirectExecute(PreparedStatement stmt);
 
+    //! Directly executes statements of a script in one transaction over a temporary connection, see SQLScript::Split.
+    //! Returns false if a statement failed, the ones which don't commit implicitly are rolled back.
+    bool DirectExecuteScript(std::vector<std::string_view> const& statements);
+
     /**
         Synchronous query (with resultset) methods.
     */
@@ -133,7 +149,7 @@ public:
         if (sql.empty())
             return { nullptr };
 
-        return Query(Warhead::StringFormat(sql, std::forward<Args>(args)...));
+        return Query(QueryBuilder::Format(sql, std::forward<Args>(args)...));
     }
 
     //! Directly executes an SQL query in prepared format that will block the calling thread until finished.
@@ -141,24 +157,41 @@ public:
     //! Statement must be prepared with CONNECTION_SYNCH flag.
     PreparedQueryResult Query(PreparedStatement stmt);
 
+    //! Directly executes SQL queries in string format in one round trip, that will block the calling thread until finished.
+    //! Results are in the order of the queries, nullptr for a query without rows or failed one. Use for reads only.
+    std::vector<QueryResult> QueryMulti(std::vector<std::string_view> const& queries);
+
+    //! Directly executes an SQL query in string format and streams the rows from the server instead of buffering the whole result.
+    //! Use for big results only. The connection is held by the result until it's drained or destroyed, consume it on the calling thread.
+    //! GetRowCount() of a streamed result is the count of rows fetched so far.
+    QueryResult QueryStream(std::string_view sql);
+
+    //! Directly executes an SQL query in prepared format through a read only server side cursor, prefetchRows rows are fetched at once.
+    //! Use for big results only. The connection is held by the result until it's drained or destroyed, consume it on the calling thread.
+    //! Statement must be prepared with CONNECTION_SYNCH flag.
+    PreparedQueryResult QueryStream(PreparedStatement stmt, uint32 prefetchRows = DEFAULT_STREAM_PREFETCH_ROWS);
+
     /**
         Asynchronous query (with resultset) methods.
     */
 
-    //! Enqueues a query in string format that will set the value of the QueryResultFuture return object as soon as the query is executed.
+    //! Enqueues a query in string format that will complete the returned callback as soon as the query is executed.
     //! The return value is then processed in ProcessQueryCallback methods.
-    QueryCallback AsyncQuery(std::string_view sql);
+    //! With a timeout the query is dropped if it isn't done in time, the callback is not invoked then.
+    QueryCallback AsyncQuery(std::string_view sql, Milliseconds timeout = 0ms, QueryPriority priority = QueryPriority::Interactive);
 
-    //! Enqueues a query in prepared format that will set the value of the PreparedQueryResultFuture return object as soon as the query is executed.
+    //! Enqueues a query in prepared format that will complete the returned callback as soon as the query is executed.
     //! The return value is then processed in ProcessQueryCallback methods.
     //! Statement must be prepared with CONNECTION_ASYNC flag.
-    QueryCallback AsyncQuery(PreparedStatement stmt);
+    //! With a timeout the query is dropped if it isn't done in time, the callback is not invoked then.
+    QueryCallback AsyncQuery(PreparedStatement stmt, Milliseconds timeout = 0ms, QueryPriority priority = QueryPriority::Interactive);
 
     //! Enqueues a vector of SQL operations (can be both adhoc and prepared) that will set the value of the QueryResultHolderFuture
     //! return object as soon as the query is executed.
     //! The return value is then processed in ProcessQueryCallback methods.
     //! Any prepared statements added to this holder need to be prepared with the CONNECTION_ASYNC flag.
-    SQLQueryHolderCallback DelayQueryHolder(SQLQueryHolder holder);
+    //! Parallel holder is split over the async connections, use it only if the queries don't depend on each other.
+    SQLQueryHolderCallback DelayQueryHolder(SQLQueryHolder holder, bool parallel = false);
 
     /**
         Transaction context methods.
@@ -196,12 +229,36 @@ public:
     //! This object is not tied to the prepared statement on the MySQL context yet until execution.
     PreparedStatement GetPreparedStatement(uint32 index);
 
-    void PrepareStatement(uint32 index, std::string_view sql, ConnectionFlags flags);
+    //! Typed prepared statement, see Stmt in TypedPreparedStatement.h. Types of parameters are checked at compile time.
+    template<typename S>
+    std::shared_ptr<TypedPreparedStatement<S>> GetPreparedStatement()
+    {
+        return std::allocate_shared<TypedPreparedStatement<S>>(DatabasePoolAllocator<TypedPreparedStatement<S>>());
+    }
+
+    void PrepareStatement(uint32 index, std::string_view sql, ConnectionFlags flags, std::optional<uint8> paramCount = {});
+
+    //! Prepares a typed statement, count of its parameters is validated against the server
+    template<typename S>
+    void PrepareStatement(std::string_view sql, ConnectionFlags flags)
+    {
+        PrepareStatement(S::StatementIndex, sql, flags, S::ParamCount);
+    }
+
+    //! Results of the prepared query are cached for ttl, see QueryResultCache. Must be called in DoPrepareStatements.
+    void EnableResultCache(uint32 index, Milliseconds ttl, uint8 partitionParams = 0);
+
+    //! Execution of writeIndex drops cached results of readIndex of the partition given by writeParams (all if empty)
+    void AddResultCacheInvalidation(uint32 writeIndex, uint32 readIndex, std::vector<uint8> writeParams = {});
+
+    [[nodiscard]] inline QueryResultCache* GetResultCache() const { return _resultCache.get(); }
+    [[nodiscard]] inline QueryStatistics* GetStatistics() const { return _statistics.get(); }
 
     // Close dynamic connections if need
     void CleanupConnections();
 
     //! Apply escape string'ing for current collation. (utf8)
+    //! Escaped on the client, the string is only reallocated if it grows beyond its capacity.
     void EscapeString(std::string& str);
 
     //! Keeps all our MySQL connections alive, prevent the server from disconnecting us.
@@ -222,14 +279,14 @@ public:
 
     void Update(Milliseconds diff);
     [[nodiscard]] std::size_t GetQueueSize() const;
+    [[nodiscard]] std::size_t GetQueueSize(QueryPriority priority) const;
 
+    //! Connection is opened and prepared in background, it's used once ready
     void OpenDynamicAsyncConnect();
     void OpenDynamicSyncConnect();
 
     void GetPoolInfo(std::function<void(std::string_view)> const& info);
 
-    inline std::string_view GetPathToExtraFile() { return _pathToExtraFile; }
-
     void CheckCleanup();
     void CheckAsyncQueue();
 
@@ -241,37 +298,49 @@ protected:
 
 private:
     std::pair<uint32, MySQLConnection*> OpenConnection(InternalIndex type, bool isDynamic = false);
-    void InitPrepareStatement(MySQLConnection* connection);
+    void OpenDynamicConnect(InternalIndex type);
+    void WaitForConnectTasks();
 
-    unsigned long EscapeString(char* to, char const* from, unsigned long length);
+    void InvalidateResultCache(Transaction& transaction);
     void AddTasks();
-    void MakeExtraFile();
 
-    //! Gets a free connection in the synchronous connection pool.
+    //! Gets a free connection in the synchronous connection pool, nullptr while the server is unreachable.
     //! Caller MUST call t->Unlock() after touching the MySQL context to prevent deadlocks.
     MySQLConnection* GetFreeConnection();
+    MySQLConnection* LockFreeConnection();
+
+    //! Usable replica for a read only statement, nullptr if the statement is executed on the primary
+    DatabaseReplica* GetReplica(uint32 index);
 
     // Get using db name from connection info
     [[nodiscard]] std::string_view GetDatabaseName() const;
 
-    std::unordered_map<uint32, StringPreparedStatement> _stringPreparedStatement;
     std::array<std::vector<std::unique_ptr<MySQLConnection>>, IDX_SIZE> _connections;
     std::unique_ptr<MySQLConnectionInfo> _connectionInfo;
-    std::vector<uint8> _preparedStatementSize;
-    std::mutex _openSyncConnectMutex;
-    std::mutex _openAsyncConnectMutex;
     std::mutex _cleanupMutex;
+    std::condition_variable _connectionFreed; ///< Notified when a sync connection is unlocked or becomes ready
+    std::mutex _connectTasksMutex;
+    std::vector<std::future<void>> _connectTasks; ///< Dynamic connections being opened and prepared
+    std::array<std::atomic<uint32>, IDX_SIZE> _pendingConnections{};
     std::string _poolName;
-    std::string _pathToExtraFile;
     DatabaseType _poolType{ DatabaseType::None };
     std::unique_ptr<TaskScheduler> _scheduler;
+    std::unique_ptr<PreparedStatementRegistry> _statementRegistry;
+    std::unique_ptr<QueryResultCache> _resultCache;
+    std::unique_ptr<QueryStatistics> _statistics;
+    std::unique_ptr<DatabaseCircuitBreaker> _circuitBreaker;
 
     // Async queue
-    std::unique_ptr<ProducerConsumerQueue<AsyncOperation*>> _queue;
+    std::unique_ptr<AsyncOperationQueue> _queue;
     std::unique_ptr<ProducerConsumerQueue<CheckAsyncQueueTask*>> _asyncQueueCheckQueue;
     std::unique_ptr<AsyncDBQueueChecker> _asyncQueueChecker;
     std::size_t _maxAsyncQueueSize{ 10 };
 
+    // Read replicas, destroyed before the queue they fall back to
+    std::vector<std::unique_ptr<DatabaseReplica>> _replicas;
+    std::atomic<uint32> _nextReplica{};
+    Seconds _replicaMaxLag{};
+
 #ifdef WARHEAD_DEBUG
     static inline thread_local bool _warnSyncQueries = false;
 #endif
@@ -23,6 +23,7 @@
 #include "Log.h"
 #include "StringConvert.h"
 #include "Types.h"
+#include <charconv>
 
 namespace
 {
@@ -143,6 +144,8 @@ Field::Field()
     data.value = nullptr;
     data.length = 0;
     data.raw = false;
+    number.u64 = 0;
+    number.type = DecodedNumber::None;
     meta = nullptr;
 }
 
@@ -158,6 +161,7 @@ void Field::SetByteValue(char const* newValue, uint32 length)
     data.value = newValue;
     data.length = length;
     data.raw = true;
+    number.type = DecodedNumber::None;
 }
 
 void Field::SetStructuredValue(char const* newValue, uint32 length)
@@ -166,6 +170,68 @@ void Field::SetStructuredValue(char const* newValue, uint32 length)
     data.value = newValue;
     data.length = length;
     data.raw = false;
+    number.type = DecodedNumber::None;
+}
+
+void Field::DecodeNumericValue()
+{
+    if (!data.value)
+        return;
+
+    char const* end = data.value + data.length;
+    std::from_chars_result result{};
+
+    switch (meta->Type)
+    {
+        case DatabaseFieldTypes::Int8:
+        case DatabaseFieldTypes::Int16:
+        case DatabaseFieldTypes::Int32:
+        case DatabaseFieldTypes::Int64:
+            if (meta->Unsigned)
+            {
+                result = std::from_chars(data.value, end, number.u64);
+                number.type = DecodedNumber::Unsigned;
+            }
+            else
+            {
+                result = std::from_chars(data.value, end, number.i64);
+                number.type = DecodedNumber::Signed;
+            }
+            break;
+        case DatabaseFieldTypes::Decimal:
+            // Keep integral decimals (SUM of integers) exact
+            result = std::from_chars(data.value, end, number.i64);
+            if (result.ec == std::errc() && result.ptr == end)
+            {
+                number.type = DecodedNumber::Signed;
+                return;
+            }
+            [[fallthrough]];
+        case DatabaseFieldTypes::Float:
+        case DatabaseFieldTypes::Double:
+            result = std::from_chars(data.value, end, number.f64);
+            number.type = DecodedNumber::Real;
+            break;
+        default:
+            return;
+    }
+
+    if (result.ec != std::errc() || result.ptr != end)
+        number.type = DecodedNumber::None;
+}
+
+template<typename T>
+T Field::GetDecodedNumber() const
+{
+    switch (number.type)
+    {
+        case DecodedNumber::Signed:
+            return static_cast<T>(number.i64);
+        case DecodedNumber::Unsigned:
+            return static_cast<T>(number.u64);
+        default:
+            return static_cast<T>(number.f64);
+    }
 }
 
 bool Field::IsType(DatabaseFieldTypes type) const
@@ -210,6 +276,9 @@ T Field::GetData() const
     }
 #endif
 
+    if (number.type != DecodedNumber::None)
+        return GetDecodedNumber<T>();
+
     std::optional<T> result;
 
     if (data.raw)
@@ -283,6 +352,54 @@ template WH_DATABASE_API int64 Field::GetData() const;
 template WH_DATABASE_API float Field::GetData() const;
 template WH_DATABASE_API double Field::GetData() const;
 
+template<typename T>
+T Field::GetUnchecked() const
+{
+    if (!data.value)
+        return T{};
+
+    if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+        return T{ data.value, data.length };
+    else if constexpr (std::is_same_v<T, Binary>)
+        return T(reinterpret_cast<uint8 const*>(data.value), reinterpret_cast<uint8 const*>(data.value) + data.length);
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        if (number.type != DecodedNumber::None)
+            return GetDecodedNumber<bool>();
+
+        return data.raw ? *reinterpret_cast<uint8 const*>(data.value) != 0 : Warhead::StringTo<bool>({ data.value, data.length }).value_or(false);
+    }
+    else
+    {
+        if (number.type != DecodedNumber::None)
+            return GetDecodedNumber<T>();
+
+        if (data.raw)
+        {
+            T value;
+            memcpy(&value, data.value, sizeof(T));
+            return value;
+        }
+
+        return Warhead::StringTo<T>({ data.value, data.length }).value_or(T{});
+    }
+}
+
+template WH_DATABASE_API bool Field::GetUnchecked() const;
+template WH_DATABASE_API uint8 Field::GetUnchecked() const;
+template WH_DATABASE_API uint16 Field::GetUnchecked() const;
+template WH_DATABASE_API uint32 Field::GetUnchecked() const;
+template WH_DATABASE_API uint64 Field::GetUnchecked() const;
+template WH_DATABASE_API int8 Field::GetUnchecked() const;
+template WH_DATABASE_API int16 Field::GetUnchecked() const;
+template WH_DATABASE_API int32 Field::GetUnchecked() const;
+template WH_DATABASE_API int64 Field::GetUnchecked() const;
+template WH_DATABASE_API float Field::GetUnchecked() const;
+template WH_DATABASE_API double Field::GetUnchecked() const;
+template WH_DATABASE_API std::string Field::GetUnchecked() const;
+template WH_DATABASE_API std::string_view Field::GetUnchecked() const;
+template WH_DATABASE_API Binary Field::GetUnchecked() const;
+
 std::string Field::GetDataString() const
 {
     if (!data.value)
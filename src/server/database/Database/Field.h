@@ -49,6 +49,7 @@ struct QueryResultFieldMetadata
     std::string TypeName;
     uint32 Index{ 0 };
     DatabaseFieldTypes Type{ DatabaseFieldTypes::Null };
+    bool Unsigned{ false };
 };
 
 /**
@@ -133,6 +134,11 @@ public:
         return data.value == nullptr;
     }
 
+    //! Decodes the value without any type checks, the column type must be validated before (see RowSchema).
+    //! Null values are decoded as default values.
+    template<typename T>
+    [[nodiscard]] T GetUnchecked() const;
+
     DatabaseFieldTypes GetType() { return meta->Type; }
 
 protected:
@@ -143,9 +149,33 @@ protected:
         bool raw;          // Raw bytes? (Prepared statement or ad hoc)
     } data;
 
+    enum class DecodedNumber : uint8
+    {
+        None,
+        Signed,
+        Unsigned,
+        Real
+    };
+
+    //! Numeric value of an ad hoc result, decoded once when the row is fetched so getters don't parse text
+    struct
+    {
+        union
+        {
+            int64 i64;
+            uint64 u64;
+            double f64;
+        };
+
+        DecodedNumber type;
+    } number;
+
     void SetByteValue(char const* newValue, uint32 length);
     void SetStructuredValue(char const* newValue, uint32 length);
 
+    //! Parses the text value of a numeric column, keeps the text only path if it isn't a plain number
+    void DecodeNumericValue();
+
     [[nodiscard]] bool IsType(DatabaseFieldTypes type) const;
     [[nodiscard]] bool IsNumeric() const;
 
@@ -153,6 +183,9 @@ private:
     template<typename T>
     [[nodiscard]] T GetData() const;
 
+    template<typename T>
+    [[nodiscard]] T GetDecodedNumber() const;
+
     [[nodiscard]] std::string GetDataString() const;
     [[nodiscard]] std::string_view GetDataStringView() const;
     [[nodiscard]] Binary GetDataBinary() const;
@@ -24,10 +24,20 @@ void DiscordDatabasePool::DoPrepareStatements()
     SetStatementSize(MAX_LOGIN_DATABASE_STATEMENTS);
 
     // Nickname
-    PrepareStatement(DISCORD_SEL_NICKNAMES, "SELECT `nickname`, `ilvl`, `game_spec`, `twinks` FROM `guild_players` WHERE `discord_guild_id` = ?", ConnectionFlags::Async);
-    PrepareStatement(DISCORD_SEL_NICKNAME, "SELECT `nickname` FROM `guild_players` WHERE `discord_guild_id` = ? AND `nickname` = ?", ConnectionFlags::Async);
-    PrepareStatement(DISCORD_DEL_NICKNAME, "DELETE FROM `guild_players` WHERE `discord_guild_id` = ? AND `nickname` = ?", ConnectionFlags::Async);
-    PrepareStatement(DISCORD_INS_NICKNAME, "INSERT INTO `guild_players` (`discord_guild_id`, `user_id`, `nickname`, `ilvl`, `game_spec`) VALUES (?, ?, ?, ?, ?)", ConnectionFlags::Async);
-    PrepareStatement(DISCORD_UPD_NICKNAME, "UPDATE `guild_players` SET `twinks` = ? WHERE `discord_guild_id` = ? AND nickname LIKE ?", ConnectionFlags::Async);
-    PrepareStatement(DISCORD_UPD_ILVL, "UPDATE `guild_players` SET `ilvl` = ? WHERE `discord_guild_id` = ? AND nickname LIKE ?", ConnectionFlags::Async);
+    PrepareStatement<DiscordSelNicknamesStmt>("SELECT `nickname`, `ilvl`, `game_spec`, `twinks` FROM `guild_players` WHERE `discord_guild_id` = ?", ConnectionFlags::AsyncReadOnly);
+    PrepareStatement<DiscordSelNicknameStmt>("SELECT `nickname` FROM `guild_players` WHERE `discord_guild_id` = ? AND `nickname` = ?", ConnectionFlags::AsyncReadOnly);
+    PrepareStatement<DiscordDelNicknameStmt>("DELETE FROM `guild_players` WHERE `discord_guild_id` = ? AND `nickname` = ?", ConnectionFlags::Async);
+    PrepareStatement<DiscordInsNicknameStmt>("INSERT INTO `guild_players` (`discord_guild_id`, `user_id`, `nickname`, `ilvl`, `game_spec`) VALUES (?, ?, ?, ?, ?)", ConnectionFlags::Async);
+    PrepareStatement<DiscordUpdNicknameStmt>("UPDATE `guild_players` SET `twinks` = ? WHERE `discord_guild_id` = ? AND nickname LIKE ?", ConnectionFlags::Async);
+    PrepareStatement<DiscordUpdIlvlStmt>("UPDATE `guild_players` SET `ilvl` = ? WHERE `discord_guild_id` = ? AND nickname LIKE ?", ConnectionFlags::Async);
+
+    // Result cache, partitioned by guild id
+    for (uint32 readIndex : { DISCORD_SEL_NICKNAMES, DISCORD_SEL_NICKNAME })
+    {
+        EnableResultCache(readIndex, 10min, 1);
+        AddResultCacheInvalidation(DISCORD_INS_NICKNAME, readIndex, { 0 });
+        AddResultCacheInvalidation(DISCORD_DEL_NICKNAME, readIndex, { 0 });
+        AddResultCacheInvalidation(DISCORD_UPD_NICKNAME, readIndex, { 1 });
+        AddResultCacheInvalidation(DISCORD_UPD_ILVL, readIndex, { 1 });
+    }
 }
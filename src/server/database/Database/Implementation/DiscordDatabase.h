@@ -19,6 +19,7 @@
 #define DISCORD_DATABASE_H_
 
 #include "DatabaseWorkerPool.h"
+#include "TypedPreparedStatement.h"
 
 enum DiscordDatabaseStatements : uint32
 {
@@ -38,6 +39,14 @@ enum DiscordDatabaseStatements : uint32
     MAX_LOGIN_DATABASE_STATEMENTS
 };
 
+// Typed descriptors of statements, parameters are in the order of placeholders
+using DiscordSelNicknamesStmt = Stmt<DISCORD_SEL_NICKNAMES, uint64>;
+using DiscordSelNicknameStmt  = Stmt<DISCORD_SEL_NICKNAME, uint64, std::string_view>;
+using DiscordDelNicknameStmt  = Stmt<DISCORD_DEL_NICKNAME, uint64, std::string_view>;
+using DiscordInsNicknameStmt  = Stmt<DISCORD_INS_NICKNAME, uint64, uint64, std::string_view, int32, std::string_view>;
+using DiscordUpdNicknameStmt  = Stmt<DISCORD_UPD_NICKNAME, std::string_view, uint64, std::string_view>;
+using DiscordUpdIlvlStmt      = Stmt<DISCORD_UPD_ILVL, int32, uint64, std::string_view>;
+
 class WH_DATABASE_API DiscordDatabasePool : public DatabaseWorkerPool
 {
 public:
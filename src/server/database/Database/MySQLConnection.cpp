@@ -17,19 +17,28 @@
 
 #include "MySQLConnection.h"
 #include "DatabaseAsyncOperation.h"
+#include "DatabaseAsyncQueue.h"
 #include "DatabaseAsyncQueueWorker.h"
+#include "DatabaseCircuitBreaker.h"
 #include "Errors.h"
 #include "Log.h"
 #include "MySQLHacks.h"
 #include "MySQLPreparedStatement.h"
-#include "PCQueue.h"
 #include "PreparedStatement.h"
+#include "PreparedStatementRegistry.h"
 #include "QueryResult.h"
+#include "QueryResultCache.h"
+#include "QueryStatistics.h"
 #include "StopWatch.h"
 #include "StringConvert.h"
+#include "StringFormat.h"
 #include "Tokenize.h"
 #include "Transaction.h"
+#include <algorithm>
+#include <bit>
+#include <cctype>
 #include <errmsg.h>
+#include <limits>
 #include <mysql.h>
 #include <mysqld_error.h>
 #include <utility>
@@ -39,6 +48,31 @@ namespace
     constexpr auto DB_DEFAULT_CHARSET = "utf8mb4";
     constexpr auto DYNAMIC_CONNECTION_TIMEOUT = 1s;
 
+    // Unreachable server doesn't block the reconnecting thread for the OS default of minutes
+    constexpr auto DB_CONNECT_TIMEOUT = 5s;
+
+    // Statements of a script are sent in batches up to this size, a bigger statement is sent alone
+    constexpr std::size_t SCRIPT_BATCH_SIZE = 1024 * 1024;
+
+    // Statement isn't retried after this many reconnects without a successful query in between
+    constexpr uint8 MAX_RETRIES_AFTER_RECONNECT = 3;
+
+    // Statement interrupted by max_execution_time (MySQL) or max_statement_time (MariaDB), not defined by both headers
+    constexpr uint32 ER_MYSQL_QUERY_TIMEOUT = 3024;
+    constexpr uint32 ER_MARIADB_STATEMENT_TIMEOUT = 1969;
+
+    // Rounded down to eight steps per power of two, a query isn't run much past its deadline
+    // and similar deadlines don't change the session variable every time
+    uint32 RoundStatementTimeLimit(Milliseconds limit)
+    {
+        if (limit <= 0ms)
+            return 0;
+
+        uint32 const limitMs = uint32(std::min<int64>(limit.count(), std::numeric_limits<uint32>::max()));
+        uint32 const step = std::max(std::bit_floor(limitMs) / 8, 1u);
+        return limitMs - limitMs % step;
+    }
+
     std::string GetConnectionFlagString(ConnectionFlags flag)
     {
         switch (flag)
@@ -68,15 +102,12 @@ MySQLConnectionInfo::MySQLConnectionInfo(std::string_view infoString)
         SSL.assign(tokens.at(5));
 }
 
-MySQLConnection::MySQLConnection(MySQLConnectionInfo& connInfo, ProducerConsumerQueue<AsyncOperation*>* dbQueue, bool isDynamic /*= false*/) :
+MySQLConnection::MySQLConnection(MySQLConnectionInfo& connInfo, AsyncOperationQueue* dbQueue, bool isDynamic /*= false*/) :
     _connectionInfo(connInfo),
     _isDynamic(isDynamic),
     _connectionFlags(dbQueue ? ConnectionFlags::Async : ConnectionFlags::Sync),
     _queue(dbQueue)
 {
-    if (_queue)
-        _asyncQueueWorker = std::make_unique<AsyncDBQueueWorker>(_queue, this);
-
     UpdateLastUseTime();
 }
 
@@ -86,6 +117,18 @@ MySQLConnection::~MySQLConnection()
     LOG_DEBUG("db.connection", "> Close {} connection to '{}' db", GetConnectionFlagString(_connectionFlags), _connectionInfo.Database);
 }
 
+void MySQLConnection::SetReady()
+{
+    if (IsReady())
+        return;
+
+    // Worker takes operations at once, statements it executes must be prepared
+    if (_queue)
+        _asyncQueueWorker = std::make_unique<AsyncDBQueueWorker>(_queue, this);
+
+    _ready.store(true, std::memory_order_release);
+}
+
 void MySQLConnection::Close()
 {
     _asyncQueueWorker.reset();
@@ -111,6 +154,9 @@ uint32 MySQLConnection::Open()
 
     mysql_options(mysqlInit, MYSQL_SET_CHARSET_NAME, DB_DEFAULT_CHARSET);
 
+    unsigned int connectTimeout = static_cast<unsigned int>(DB_CONNECT_TIMEOUT.count());
+    mysql_options(mysqlInit, MYSQL_OPT_CONNECT_TIMEOUT, (char const*)&connectTimeout);
+
     if (_connectionInfo.Host == ".")
     {
 #if WARHEAD_PLATFORM == WARHEAD_PLATFORM_WINDOWS
@@ -139,6 +185,7 @@ uint32 MySQLConnection::Open()
 #endif
     }
 
+    // Multiple statements are enabled by QueryMulti and ExecuteScript and disabled before a single query (see SetMultiStatements)
     _mysqlHandle = reinterpret_cast<MySQLHandle*>(mysql_real_connect(mysqlInit, _connectionInfo.Host.c_str(), _connectionInfo.User.c_str(),
     _connectionInfo.Password.c_str(), _connectionInfo.Database.c_str(), port, unix_socket, 0));
 
@@ -147,9 +194,31 @@ uint32 MySQLConnection::Open()
         LOG_MSG_BODY("db.connection", _isDynamic ? Warhead::LogLevel::Debug : Warhead::LogLevel::Info, "Open new {} connect to DB at {}", GetConnectionFlagString(_connectionFlags), _connectionInfo.Host);
         mysql_autocommit(_mysqlHandle, 1);
 
+        // New session has no statement time limit, the server could support it after an upgrade
+        _statementTimeLimit = 0;
+        _hasStatementTimeLimit = true;
+        _multiStatements = false;
+
         // set connection properties to UTF8 to properly handle locales for different
         // server configs - core sends data in UTF8, so MySQL must expect UTF8 too
         mysql_set_character_set(_mysqlHandle, DB_DEFAULT_CHARSET);
+
+        // Values are escaped on the client with backslashes (see EscapeSQLString).
+        // With NO_BACKSLASH_ESCAPES an escaped quote would end the string, so the mode is removed from the session.
+        if (_mysqlHandle->server_status & SERVER_STATUS_NO_BACKSLASH_ESCAPES)
+        {
+            mysql_query(_mysqlHandle, "SET SESSION sql_mode = TRIM(BOTH ',' FROM REPLACE(CONCAT(',', @@SESSION.sql_mode, ','), ',NO_BACKSLASH_ESCAPES,', ','))");
+
+            if (_mysqlHandle->server_status & SERVER_STATUS_NO_BACKSLASH_ESCAPES)
+            {
+                uint32 errorCode = mysql_errno(_mysqlHandle);
+                LOG_ERROR("db.connection", "[{}]: Could not disable NO_BACKSLASH_ESCAPES of database `{}`: {}", errorCode, _connectionInfo.Database, mysql_error(_mysqlHandle));
+                mysql_close(_mysqlHandle);
+                _mysqlHandle = nullptr;
+                return errorCode ? errorCode : CR_UNKNOWN_ERROR;
+            }
+        }
+
         return 0;
     }
     else
@@ -161,7 +230,112 @@ uint32 MySQLConnection::Open()
     }
 }
 
+bool MySQLConnection::Reconnect()
+{
+    if (_mysqlHandle)
+    {
+        mysql_close(_mysqlHandle);
+        _mysqlHandle = nullptr;
+    }
+
+    if (Open())
+        return false;
+
+    ClearPreparedStatements();
+    return true;
+}
+
+bool MySQLConnection::WaitForReconnect(TimePoint deadline)
+{
+    if (IsConnected())
+        return true;
+
+    // Replicas are reconnected by their health check
+    if (!_circuitBreaker)
+        return Reconnect();
+
+    for (;;)
+    {
+        if (_circuitBreaker->TryProbe())
+        {
+            bool const isConnected = Reconnect();
+            _circuitBreaker->ReportProbe(isConnected);
+
+            if (isConnected)
+                return true;
+        }
+        else if (_circuitBreaker->IsClosed())
+        {
+            // Only this connection was dropped, e.g. by wait_timeout of the server
+            if (Reconnect())
+                return true;
+
+            _circuitBreaker->Trip();
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline)
+            return false;
+
+        if (!_circuitBreaker->WaitForProbe(deadline))
+            return false;
+    }
+}
+
+TimePoint MySQLConnection::GetParkDeadline(TimePoint since) const
+{
+    if (!_queue || !_circuitBreaker)
+        return since;
+
+    return since + _circuitBreaker->GetParkTimeout();
+}
+
+void MySQLConnection::SetStatementTimeLimit(Milliseconds limit)
+{
+    if (!_mysqlHandle || !_hasStatementTimeLimit)
+        return;
+
+    uint32 const limitMs = RoundStatementTimeLimit(limit);
+    if (limitMs == _statementTimeLimit)
+        return;
+
+    // Both variables exist on the supported server versions (MySQL 5.7.8, MariaDB 10.1), MariaDB one is in seconds
+    bool const isMariaDB = GetServerVersion() >= 100000;
+    std::string sql = isMariaDB ? Warhead::StringFormat("SET SESSION max_statement_time = {}", limitMs / 1000.0) :
+        Warhead::StringFormat("SET SESSION max_execution_time = {}", limitMs);
+
+    // Not through Execute, it isn't recorded as a query
+    if (mysql_query(_mysqlHandle, sql.c_str()))
+    {
+        uint32 const err = mysql_errno(_mysqlHandle);
+
+        if (err == ER_UNKNOWN_SYSTEM_VARIABLE)
+        {
+            LOG_WARN("db.connection", "Statement time limit isn't supported by the server, deadlines of running queries are ignored. [{}] {}", err, mysql_error(_mysqlHandle));
+            _hasStatementTimeLimit = false;
+            return;
+        }
+
+        LOG_ERROR("db.connection", "[{}] Could not set the statement time limit: {}", err, mysql_error(_mysqlHandle));
+
+        // Session of the reconnected handle has no limit yet
+        if (HandleMySQLError(err))
+            SetStatementTimeLimit(limit);
+
+        return;
+    }
+
+    _statementTimeLimit = limitMs;
+}
+
 bool MySQLConnection::Execute(std::string_view sql)
+{
+    if (!SetMultiStatements(false))
+        return false;
+
+    return ExecuteStatement(sql);
+}
+
+bool MySQLConnection::ExecuteStatement(std::string_view sql)
 {
     if (!_mysqlHandle || sql.empty())
         return false;
@@ -175,16 +349,21 @@ bool MySQLConnection::Execute(std::string_view sql)
 
             LOG_ERROR("db.query", "[{}] {}", err, mysql_error(_mysqlHandle));
             LOG_ERROR("db.query", "Query: {}", sql);
+            RecordQuery(sql, sw.Elapsed(), true);
 
             if (HandleMySQLError(err)) // If it returns true, an error was handled successfully (i.e. reconnection)
-                return Execute(sql); // Try again
+                return ExecuteStatement(sql); // Try again
 
             return false;
         }
         else
+        {
             LOG_DEBUG("db.query", "[{}] Query: {}", sw, sql);
+            RecordQuery(sql, sw.Elapsed(), false);
+        }
     }
 
+    DrainResults();
     UpdateLastUseTime();
     return true;
 }
@@ -211,11 +390,13 @@ bool MySQLConnection::Execute(PreparedStatement stmt)
         uint32 err = mysql_errno(_mysqlHandle);
         LOG_ERROR("db.query", "[{}] {}", err, mysql_stmt_error(msql_STMT));
         LOG_ERROR("db.query", "Query(p): {}", mStmt->getQueryString());
+        RecordQuery(index, mStmt, sw.Elapsed(), true);
 
         if (HandleMySQLError(err)) // If it returns true, an error was handled successfully (i.e. reconnection)
             return Execute(stmt); // Try again
 
         mStmt->ClearParameters();
+        mStmt->Reset();
         return false;
     }
 
@@ -224,18 +405,25 @@ bool MySQLConnection::Execute(PreparedStatement stmt)
         uint32 err = mysql_errno(_mysqlHandle);
         LOG_ERROR("db.query", "[{}] {}", err, mysql_stmt_error(msql_STMT));
         LOG_ERROR("db.query", "Query(p): {}", mStmt->getQueryString());
+        RecordQuery(index, mStmt, sw.Elapsed(), true);
 
         if (HandleMySQLError(err))  // If it returns true, an error was handled successfully (i.e. reconnection)
             return Execute(stmt); // Try again
 
         mStmt->ClearParameters();
+        mStmt->Reset();
         return false;
     }
 
     LOG_DEBUG("db.query", "[{}] Query(p): {}", sw, mStmt->getQueryString());
+    RecordQuery(index, mStmt, sw.Elapsed(), false);
 
     mStmt->ClearParameters();
     UpdateLastUseTime();
+
+    if (_resultCache)
+        _resultCache->Invalidate(*stmt);
+
     return true;
 }
 
@@ -263,19 +451,264 @@ PreparedQueryResult MySQLConnection::Query(PreparedStatement stmt)
     uint64 rowCount = 0;
     uint32 fieldCount = 0;
 
+    uint32 const index = stmt->GetIndex();
+
     if (!Query(std::move(stmt), &mysqlStmt, &result, &rowCount, &fieldCount))
         return nullptr;
 
-    if (mysql_more_results(_mysqlHandle))
-        mysql_next_result(_mysqlHandle);
+    DrainResults();
+    UpdateLastUseTime();
+
+    auto preparedResult = std::make_shared<PreparedResultSet>(mysqlStmt->GetSTMT(), result, rowCount, fieldCount);
+
+    if (_statistics)
+        _statistics->RecordRows(index, preparedResult->GetRowCount());
+
+    return preparedResult;
+}
+
+std::vector<QueryResult> MySQLConnection::QueryMulti(std::vector<std::string_view> const& queries)
+{
+    std::vector<QueryResult> results(queries.size());
+
+    if (!_mysqlHandle || queries.empty())
+        return results;
+
+    std::string sql;
+
+    for (auto query : queries)
+    {
+        if (!sql.empty())
+            sql += ';';
+
+        // Trailing separator would be an empty statement
+        while (!query.empty() && (query.back() == ';' || std::isspace(static_cast<unsigned char>(query.back()))))
+            query.remove_suffix(1);
+
+        sql += query;
+    }
+
+    // Stays enabled for the next batch (e.g. of the same query holder), a single query disables it first
+    if (queries.size() > 1 && !SetMultiStatements(true))
+        return results;
+
+    StopWatch sw;
+
+    if (mysql_query(_mysqlHandle, sql.c_str()))
+    {
+        uint32 err = mysql_errno(_mysqlHandle);
+        LOG_ERROR("db.query", "[{}] {}", err, mysql_error(_mysqlHandle));
+        LOG_ERROR("db.query", "Query: {}", sql);
+        RecordQuery(sql, sw.Elapsed(), true);
+
+        if (HandleMySQLError(err)) // Only reads are batched, the whole batch is sent again
+            return QueryMulti(queries);
+
+        return results;
+    }
+
+    // Server stops at the first failed statement, the ones before it have a result each
+    bool hasError{};
+
+    for (std::size_t i{}; i < queries.size(); ++i)
+    {
+        if (auto result = mysql_store_result(_mysqlHandle))
+        {
+            uint64 const rowCount = mysql_affected_rows(_mysqlHandle);
+
+            if (_statistics)
+                _statistics->RecordRows(QueryStatistics::STRING_QUERY_INDEX, rowCount);
+
+            if (rowCount)
+                results[i] = std::make_shared<ResultSet>(reinterpret_cast<MySQLResult*>(result), reinterpret_cast<MySQLField*>(mysql_fetch_fields(result)), rowCount, mysql_field_count(_mysqlHandle));
+            else
+                mysql_free_result(result);
+        }
+
+        if (i + 1 == queries.size())
+            break;
+
+        int const status = mysql_next_result(_mysqlHandle);
+        if (status < 0)
+            break;
+
+        if (status > 0)
+        {
+            uint32 err = mysql_errno(_mysqlHandle);
+            LOG_ERROR("db.query", "[{}] {}", err, mysql_error(_mysqlHandle));
+            LOG_ERROR("db.query", "Query: {}", queries[i + 1]);
+            hasError = true;
 
+            if (HandleMySQLError(err))
+            {
+                RecordQuery(sql, sw.Elapsed(), true);
+                return QueryMulti(queries);
+            }
+
+            break;
+        }
+    }
+
+    LOG_DEBUG("db.query", "[{}] Query: {}", sw, sql);
+    RecordQuery(sql, sw.Elapsed(), hasError);
+
+    // Results of a failed batch could still be pending
+    DrainResults();
     UpdateLastUseTime();
-    return std::make_shared<PreparedResultSet>(mysqlStmt->GetSTMT(), result, rowCount, fieldCount);
+    return results;
 }
 
-bool MySQLConnection::Query(std::string_view sql, MySQLResult** result, MySQLField** fields, uint64* rowCount, uint32* fieldCount)
+bool MySQLConnection::ExecuteScript(std::vector<std::string_view> const& statements)
 {
-    if (!_mysqlHandle || sql.empty())
+    if (!_mysqlHandle)
+        return false;
+
+    if (statements.empty())
+        return true;
+
+    if (!BeginTransaction())
+        return false;
+
+    if (!SetMultiStatements(true))
+    {
+        RollbackTransaction();
+        return false;
+    }
+
+    std::string batch;
+    std::size_t first{};
+
+    for (std::size_t i{}; i <= statements.size(); ++i)
+    {
+        bool const isLast = i == statements.size();
+
+        if (!batch.empty() && (isLast || batch.size() + statements[i].size() > SCRIPT_BATCH_SIZE))
+        {
+            if (!ExecuteScriptBatch(batch, statements, first, i - first))
+            {
+                RollbackTransaction();
+                return false;
+            }
+
+            batch.clear();
+            first = i;
+        }
+
+        if (isLast)
+            break;
+
+        if (!batch.empty())
+            batch += ";\n";
+
+        batch += statements[i];
+    }
+
+    return CommitTransaction();
+}
+
+bool MySQLConnection::ExecuteScriptBatch(std::string const& batch, std::vector<std::string_view> const& statements, std::size_t first, std::size_t count)
+{
+    StopWatch sw;
+    std::size_t failed = first;
+    bool hasError = mysql_real_query(_mysqlHandle, batch.data(), batch.size()) != 0;
+
+    // Server stops at the first failed statement, results of the ones before it must be read
+    while (!hasError)
+    {
+        if (auto result = mysql_store_result(_mysqlHandle))
+            mysql_free_result(result);
+
+        int const status = mysql_next_result(_mysqlHandle);
+        if (status < 0)
+            break;
+
+        ++failed;
+        hasError = status > 0;
+    }
+
+    // Statements before the failed one are executed, the batch isn't retried after a reconnect
+    if (hasError)
+    {
+        uint32 err = mysql_errno(_mysqlHandle);
+        LOG_ERROR("db.query", "[{}] {}", err, mysql_error(_mysqlHandle));
+        LOG_ERROR("db.query", "Query: {}", statements[std::min(failed, statements.size() - 1)]);
+    }
+    else
+        LOG_DEBUG("db.query", "[{}] Script batch of {} statements", sw, count);
+
+    // Batch can be megabytes of text, it's not logged as a slow query
+    RecordQuery(Warhead::StringFormat("<script batch of {} statements>", count), sw.Elapsed(), hasError);
+    UpdateLastUseTime();
+    return !hasError;
+}
+
+bool MySQLConnection::SetMultiStatements(bool enable)
+{
+    // Every switch is a round trip, the option is only switched off before a single query runs
+    if (_multiStatements == enable)
+        return true;
+
+    if (!_mysqlHandle)
+        return false;
+
+    // A statement injected into a single query can't be executed while it's disabled
+    if (!mysql_set_server_option(_mysqlHandle, enable ? MYSQL_OPTION_MULTI_STATEMENTS_ON : MYSQL_OPTION_MULTI_STATEMENTS_OFF))
+    {
+        _multiStatements = enable;
+        return true;
+    }
+
+    LOG_ERROR("db.query", "[{}] Could not {} multiple statements: {}", mysql_errno(_mysqlHandle), enable ? "enable" : "disable", mysql_error(_mysqlHandle));
+    return false;
+}
+
+void MySQLConnection::DrainResults()
+{
+    // Results which aren't read would make the next query fail with "Commands out of sync"
+    while (_mysqlHandle && mysql_more_results(_mysqlHandle))
+    {
+        if (mysql_next_result(_mysqlHandle))
+            break;
+
+        if (auto result = mysql_store_result(_mysqlHandle))
+            mysql_free_result(result);
+    }
+}
+
+QueryResult MySQLConnection::QueryStream(std::string_view sql)
+{
+    if (sql.empty())
+        return nullptr;
+
+    MySQLResult* result = nullptr;
+    MySQLField* fields = nullptr;
+    uint64 rowCount = 0;
+    uint32 fieldCount = 0;
+
+    if (!Query(sql, &result, &fields, &rowCount, &fieldCount, true))
+        return nullptr;
+
+    UpdateLastUseTime();
+    return std::make_shared<ResultSet>(result, fields, 0, fieldCount, this);
+}
+
+PreparedQueryResult MySQLConnection::QueryStream(PreparedStatement stmt, uint32 prefetchRows)
+{
+    MySQLPreparedStatement* mysqlStmt = nullptr;
+    MySQLResult* result = nullptr;
+    uint64 rowCount = 0;
+    uint32 fieldCount = 0;
+
+    if (!Query(std::move(stmt), &mysqlStmt, &result, &rowCount, &fieldCount, std::max<uint32>(prefetchRows, 1)))
+        return nullptr;
+
+    UpdateLastUseTime();
+    return std::make_shared<PreparedResultSet>(mysqlStmt->GetSTMT(), result, fieldCount, this);
+}
+
+bool MySQLConnection::Query(std::string_view sql, MySQLResult** result, MySQLField** fields, uint64* rowCount, uint32* fieldCount, bool streamed /*= false*/)
+{
+    if (!_mysqlHandle || sql.empty() || !SetMultiStatements(false))
         return false;
 
     {
@@ -286,24 +719,35 @@ bool MySQLConnection::Query(std::string_view sql, MySQLResult** result, MySQLFie
             uint32 err = mysql_errno(_mysqlHandle);
             LOG_ERROR("db.query", "[{}] {}", err, mysql_error(_mysqlHandle));
             LOG_ERROR("db.query", "Query: {}", sql);
+            RecordQuery(sql, sw.Elapsed(), true);
 
             if (HandleMySQLError(err)) // If it returns true, an error was handled successfully (i.e. reconnection)
-                return Query(sql, result, fields, rowCount, fieldCount);    // We try again
+                return Query(sql, result, fields, rowCount, fieldCount, streamed);    // We try again
 
             return false;
         }
         else
             LOG_DEBUG("db.query", "[{}] Query: {}", sw, sql);
 
-        *result = reinterpret_cast<MySQLResult*>(mysql_store_result(_mysqlHandle));
-        *rowCount = mysql_affected_rows(_mysqlHandle);
+        // Streamed rows are read by ResultSet::NextRow, row count is unknown until the result is drained
+        *result = reinterpret_cast<MySQLResult*>(streamed ? mysql_use_result(_mysqlHandle) : mysql_store_result(_mysqlHandle));
+        *rowCount = streamed ? 0 : mysql_affected_rows(_mysqlHandle);
         *fieldCount = mysql_field_count(_mysqlHandle);
+
+        // Buffered time includes the transfer of rows
+        RecordQuery(sql, sw.Elapsed(), false);
+
+        if (_statistics && *result)
+            _statistics->RecordRows(QueryStatistics::STRING_QUERY_INDEX, *rowCount);
+
+        if (!streamed)
+            DrainResults();
     }
 
     if (!*result)
         return false;
 
-    if (!*rowCount)
+    if (!streamed && !*rowCount)
     {
         mysql_free_result(*result);
         return false;
@@ -313,7 +757,7 @@ bool MySQLConnection::Query(std::string_view sql, MySQLResult** result, MySQLFie
     return true;
 }
 
-bool MySQLConnection::Query(PreparedStatement stmt, MySQLPreparedStatement** mysqlStmt, MySQLResult** result, uint64* rowCount, uint32* fieldCount)
+bool MySQLConnection::Query(PreparedStatement stmt, MySQLPreparedStatement** mysqlStmt, MySQLResult** result, uint64* rowCount, uint32* fieldCount, uint32 prefetchRows /*= 0*/)
 {
     if (!_mysqlHandle)
         return false;
@@ -321,6 +765,11 @@ bool MySQLConnection::Query(PreparedStatement stmt, MySQLPreparedStatement** mys
     uint32 index = stmt->GetIndex();
 
     MySQLPreparedStatement* mStmt = GetPreparedStatement(index);
+
+    // Schema of a replica can differ, the query is executed on the primary then
+    if (!mStmt && _isReplica)
+        return false;
+
     ASSERT(mStmt); // Can only be null if preparation failed, server side error or bad query
 
     mStmt->BindParameters(stmt);
@@ -336,28 +785,51 @@ bool MySQLConnection::Query(PreparedStatement stmt, MySQLPreparedStatement** mys
         uint32 err = mysql_errno(_mysqlHandle);
         LOG_ERROR("db.query", "[{}] {}", err, mysql_stmt_error(msql_STMT));
         LOG_ERROR("db.query", "Query: {}", mStmt->getQueryString());
+        RecordQuery(index, mStmt, sw.Elapsed(), true);
 
         if (HandleMySQLError(err))  // If it returns true, an error was handled successfully (i.e. reconnection)
-            return Query(stmt, mysqlStmt, result, rowCount, fieldCount); // Try again
+            return Query(stmt, mysqlStmt, result, rowCount, fieldCount, prefetchRows); // Try again
 
         mStmt->ClearParameters();
+        mStmt->Reset();
         return false;
     }
 
-    if (mysql_stmt_execute(msql_STMT))
+    // Open a read only server side cursor, rows are sent by blocks of prefetchRows on mysql_stmt_fetch
+    if (prefetchRows)
+    {
+        unsigned long cursorType = CURSOR_TYPE_READ_ONLY;
+        unsigned long prefetch = prefetchRows;
+        mysql_stmt_attr_set(msql_STMT, STMT_ATTR_CURSOR_TYPE, &cursorType);
+        mysql_stmt_attr_set(msql_STMT, STMT_ATTR_PREFETCH_ROWS, &prefetch);
+    }
+
+    int executeError = mysql_stmt_execute(msql_STMT);
+
+    // Cursor type is only used on execute, don't leak it into the next buffered query on this statement
+    if (prefetchRows)
+    {
+        unsigned long cursorType = CURSOR_TYPE_NO_CURSOR;
+        mysql_stmt_attr_set(msql_STMT, STMT_ATTR_CURSOR_TYPE, &cursorType);
+    }
+
+    if (executeError)
     {
         uint32 err = mysql_errno(_mysqlHandle);
         LOG_ERROR("db.query", "[{}] {}", err, mysql_stmt_error(msql_STMT));
         LOG_ERROR("db.query", "Query: {}", mStmt->getQueryString());
+        RecordQuery(index, mStmt, sw.Elapsed(), true);
 
         if (HandleMySQLError(err))  // If it returns true, an error was handled successfully (i.e. reconnection)
-            return Query(stmt, mysqlStmt, result, rowCount, fieldCount); // Try again
+            return Query(stmt, mysqlStmt, result, rowCount, fieldCount, prefetchRows); // Try again
 
         mStmt->ClearParameters();
+        mStmt->Reset();
         return false;
     }
 
     LOG_DEBUG("db.query", "[{}] Query(p): {}", sw, mStmt->getQueryString());
+    RecordQuery(index, mStmt, sw.Elapsed(), false);
 
     mStmt->ClearParameters();
 
@@ -367,6 +839,29 @@ bool MySQLConnection::Query(PreparedStatement stmt, MySQLPreparedStatement** mys
     return true;
 }
 
+void MySQLConnection::RecordQuery(std::string_view sql, Microseconds time, bool error)
+{
+    if (!_statistics)
+        return;
+
+    _statistics->RecordQuery(QueryStatistics::STRING_QUERY_INDEX, time, error);
+
+    if (!error && _statistics->IsSlowQuery(time))
+        LOG_WARN("db.query", "Slow query ({}): {}", Warhead::Time::ToTimeString(time), sql);
+}
+
+void MySQLConnection::RecordQuery(uint32 index, MySQLPreparedStatement const* stmt, Microseconds time, bool error)
+{
+    if (!_statistics)
+        return;
+
+    _statistics->RecordQuery(index, time, error);
+
+    // Parameters are still bound, the string has their values
+    if (!error && _statistics->IsSlowQuery(time))
+        LOG_WARN("db.query", "Slow query(p) ({}): {}", Warhead::Time::ToTimeString(time), stmt->getQueryString());
+}
+
 /*static*/ std::string_view MySQLConnection::GetClientInfo()
 {
     return { mysql_get_client_info() };
@@ -377,60 +872,51 @@ std::string_view MySQLConnection::GetServerInfo()
     return { mysql_get_server_info(_mysqlHandle) };
 }
 
-bool MySQLConnection::HandleMySQLError(uint32 errNo, uint8 attempts /*= 5*/)
+bool MySQLConnection::HandleMySQLError(uint32 errNo)
 {
     switch (errNo)
     {
         case CR_SERVER_GONE_ERROR:
         case CR_SERVER_LOST:
         case CR_SERVER_LOST_EXTENDED:
+        case CR_CONN_HOST_ERROR:
         {
+            _lastError = errNo;
+
             if (_mysqlHandle)
             {
-                LOG_ERROR("db.connection", "Lost the connection to the MySQL server!");
+                LOG_ERROR("db.connection", "Lost the connection to the MySQL server! Connection flags: {}", GetConnectionFlagString(_connectionFlags));
 
                 mysql_close(_mysqlHandle);
                 _mysqlHandle = nullptr;
             }
-            [[fallthrough]];
-        }
-        case CR_CONN_HOST_ERROR:
-        {
-            LOG_INFO("db.connection", "Attempting to reconnect to the MySQL server...");
 
-            uint32 const lErrno = Open();
-            if (!lErrno)
-            {
-                if (!this->PrepareStatements())
-                {
-                    LOG_FATAL("db.connection", "Could not re-prepare statements!");
-                    ABORT("Could not re-prepare statements!");
-                }
+            // Statements executed before are rolled back by the server, the caller retries the whole transaction
+            if (_inTransaction)
+                return false;
 
-                LOG_INFO("db.connection", "Successfully reconnected to {} @{}:{} Connection flags: {}.",
-                    _connectionInfo.Database, _connectionInfo.Host, _connectionInfo.PortOrSocket, (uint8)_connectionFlags);
-
-                return true;
+            if (_retriesAfterReconnect >= MAX_RETRIES_AFTER_RECONNECT)
+            {
+                LOG_ERROR("db.connection", "Server dropped the connection {} times in a row, query is not retried", _retriesAfterReconnect);
+                return false;
             }
 
-            if ((--attempts) == 0)
-            {
-                // Shut down the server when the mysql server isn't
-                // reachable for some time
-                LOG_FATAL("db.connection", "Failed to reconnect to the MySQL server, terminating the server to prevent data corruption!");
+            if (!WaitForReconnect(GetParkDeadline(std::chrono::steady_clock::now())))
+                return false;
 
-                // We could also initiate a shutdown through using std::raise(SIGTERM)
-                ABORT("Failed to reconnect to the MySQL server, terminating the server to prevent data corruption!");
-            }
-            else
-            {
-                // It's possible this attempted to reconnect throws 2006 at us.
-                // To prevent crazy recursive calls, sleep here.
-                std::this_thread::sleep_for(3s); // Sleep 3 seconds
-                return HandleMySQLError(lErrno, attempts); // Call self (recursive)
-            }
+            LOG_INFO("db.connection", "Successfully reconnected to {} @{}:{} Connection flags: {}.",
+                _connectionInfo.Database, _connectionInfo.Host, _connectionInfo.PortOrSocket, GetConnectionFlagString(_connectionFlags));
+
+            ++_retriesAfterReconnect;
+            return true;
         }
 
+        case ER_QUERY_INTERRUPTED:
+        case ER_MYSQL_QUERY_TIMEOUT:
+        case ER_MARIADB_STATEMENT_TIMEOUT:
+            LOG_WARN("db.connection", "Query was interrupted by the server, its deadline passed or it was killed");
+            return false;
+
         case ER_LOCK_DEADLOCK: // Implemented in TransactionTask::Execute and DatabaseWorkerPool<T>::DirectCommitTransaction
         case ER_WRONG_VALUE_COUNT: // Query related errors - skip query
         case ER_DUP_ENTRY:
@@ -453,70 +939,136 @@ bool MySQLConnection::HandleMySQLError(uint32 errNo, uint8 attempts /*= 5*/)
     }
 }
 
-bool MySQLConnection::PrepareStatements() const
-{
-    return !_prepareError;
-}
-
 MySQLPreparedStatement* MySQLConnection::GetPreparedStatement(uint32 index)
 {
-    ASSERT(index < _stmtList.size(), "Tried to access invalid prepared statement index {} (max index {}) on database `{}`, connection type: {}",
-       index, _stmtList.size(), _connectionInfo.Database, GetConnectionFlagString(_connectionFlags));
+    ASSERT(_statementRegistry && index < _statementRegistry->GetSize(), "Tried to access invalid prepared statement index {} on database `{}`, connection type: {}",
+       index, _connectionInfo.Database, GetConnectionFlagString(_connectionFlags));
 
-    MySQLPreparedStatement* ret = _stmtList[index].get();
+    if (_stmtList.size() < _statementRegistry->GetSize())
+        _stmtList.resize(_statementRegistry->GetSize());
 
-    if (!ret)
+    auto& stmt = _stmtList[index];
+    if (!stmt && !PrepareStatement(index))
+    {
         LOG_ERROR("db.connection", "Could not fetch prepared statement {} on database `{}`, connection type: {}.",
             index, _connectionInfo.Database, GetConnectionFlagString(_connectionFlags));
+        return nullptr;
+    }
 
-    return ret;
+    stmt->_lastUse = ++_statementUseCounter;
+    return stmt.get();
 }
 
-void MySQLConnection::PrepareStatement(uint32 index, std::string_view sql, ConnectionFlags flags)
+bool MySQLConnection::PrepareStatement(uint32 index)
 {
-    // Check if specified query should be prepared on this connection
-    // i.e. don't prepare async statements on synchronous connections
-    // to save memory that will not be used.
-    if (!((uint8)_connectionFlags & (uint8)flags))
+    auto info = _statementRegistry->GetInfo(index);
+    if (!info)
     {
-        _stmtList[index].reset();
-        return;
+        LOG_ERROR("db.connection", "Prepared statement {} is not registered", index);
+        return false;
+    }
+
+    // Async statements are never prepared on synchronous connections and vice versa
+    if (!((uint8)_connectionFlags & (uint8)info->ConnectionType))
+    {
+        LOG_ERROR("db.connection", "Prepared statement {} is not allowed on {} connection, sql: \"{}\"", index, GetConnectionFlagString(_connectionFlags), info->Query);
+        return false;
     }
 
+    // Keep count of statements on the server below the limit
+    uint32 const maxStatements = _statementRegistry->GetMaxStatementsPerConnection();
+    if (maxStatements && _preparedCount >= maxStatements)
+        CloseLeastUsedStatement();
+
     MYSQL_STMT* stmt = mysql_stmt_init(_mysqlHandle);
     if (!stmt)
     {
-        LOG_ERROR("db.connection", "In mysql_stmt_init() id: {}, sql: \"{}\"", index, sql);
+        LOG_ERROR("db.connection", "In mysql_stmt_init() id: {}, sql: \"{}\"", index, info->Query);
         LOG_ERROR("db.connection", "{}", mysql_error(_mysqlHandle));
-        _prepareError = true;
+        return false;
     }
-    else
+
+    int prepareError = mysql_stmt_prepare(stmt, info->Query.data(), static_cast<unsigned long>(info->Query.size()));
+
+    // Server wide max_prepared_stmt_count is reached, free a handle of this connection and try again
+    if (prepareError && mysql_stmt_errno(stmt) == ER_MAX_PREPARED_STMT_COUNT_REACHED && CloseLeastUsedStatement())
+        prepareError = mysql_stmt_prepare(stmt, info->Query.data(), static_cast<unsigned long>(info->Query.size()));
+
+    if (prepareError)
     {
-        if (mysql_stmt_prepare(stmt, sql.data(), static_cast<unsigned long>(sql.size())))
-        {
-            LOG_ERROR("db.connection", "In mysql_stmt_prepare() id: {}, sql: \"{}\"", index, sql);
-            LOG_ERROR("db.connection", "{}", mysql_stmt_error(stmt));
-            mysql_stmt_close(stmt);
-            _prepareError = true;
-        }
-        else
-            _stmtList[index] = std::make_unique<MySQLPreparedStatement>(reinterpret_cast<MySQLStmt*>(stmt), sql);
+        LOG_ERROR("db.connection", "In mysql_stmt_prepare() id: {}, sql: \"{}\"", index, info->Query);
+        LOG_ERROR("db.connection", "{}", mysql_stmt_error(stmt));
+        mysql_stmt_close(stmt);
+        return false;
     }
+
+    if (info->DeclaredParamCount && mysql_stmt_param_count(stmt) != *info->DeclaredParamCount)
+    {
+        LOG_ERROR("db.connection", "In mysql_stmt_prepare() id: {}, sql: \"{}\"", index, info->Query);
+        LOG_ERROR("db.connection", "Statement is declared with {} parameters, but server expects {}", *info->DeclaredParamCount, mysql_stmt_param_count(stmt));
+        mysql_stmt_close(stmt);
+        return false;
+    }
+
+    _stmtList[index] = std::make_unique<MySQLPreparedStatement>(reinterpret_cast<MySQLStmt*>(stmt), info->Query);
+    ++_preparedCount;
+    return true;
+}
+
+bool MySQLConnection::CloseLeastUsedStatement()
+{
+    // Only done at the limit, a linear scan is cheaper than keeping a list ordered on every execution
+    auto itr = std::min_element(_stmtList.begin(), _stmtList.end(), [](auto const& left, auto const& right)
+    {
+        if (!left || !right)
+            return left != nullptr;
+
+        return left->_lastUse < right->_lastUse;
+    });
+
+    if (itr == _stmtList.end() || !*itr)
+        return false;
+
+    LOG_DEBUG("db.connection", "Close least used prepared statement: {}", (*itr)->getQueryString());
+    itr->reset();
+    --_preparedCount;
+    return true;
+}
+
+void MySQLConnection::ClearPreparedStatements()
+{
+    _stmtList.clear();
+    _preparedCount = 0;
+}
+
+bool MySQLConnection::BeginTransaction()
+{
+    _inTransaction = true;
+    return ExecuteStatement("START TRANSACTION");
 }
 
-void MySQLConnection::BeginTransaction()
+bool MySQLConnection::RollbackTransaction()
 {
-    Execute("START TRANSACTION");
+    bool result = ExecuteStatement("ROLLBACK");
+    _inTransaction = false;
+    return result;
 }
 
-void MySQLConnection::RollbackTransaction()
+bool MySQLConnection::CommitTransaction()
 {
-    Execute("ROLLBACK");
+    bool result = ExecuteStatement("COMMIT");
+    _inTransaction = false;
+    return result;
 }
 
-void MySQLConnection::CommitTransaction()
+bool MySQLConnection::SetSavepoint()
 {
-    Execute("COMMIT");
+    return ExecuteStatement("SAVEPOINT wh_savepoint");
+}
+
+bool MySQLConnection::RollbackToSavepoint()
+{
+    return ExecuteStatement("ROLLBACK TO SAVEPOINT wh_savepoint");
 }
 
 int32 MySQLConnection::ExecuteTransaction(SQLTransaction transaction)
@@ -551,6 +1103,11 @@ int32 MySQLConnection::ExecuteTransaction(SQLTransaction transaction)
                 {
                     LOG_WARN("db.query", "Transaction aborted. {} queries not executed.", queries->size());
                     int32 errorCode = GetLastError();
+
+                    if (errorCode == ER_LOCK_DEADLOCK && _statistics && _statementRegistry)
+                        if (auto info = _statementRegistry->GetInfo(stmt->GetIndex()))
+                            _statistics->RecordDeadlock(info->Query);
+
                     RollbackTransaction();
                     return errorCode;
                 }
@@ -576,6 +1133,10 @@ int32 MySQLConnection::ExecuteTransaction(SQLTransaction transaction)
                 {
                     LOG_WARN("db.query", "Transaction aborted. {} queries not executed.", queries->size());
                     int32 errorCode = GetLastError();
+
+                    if (errorCode == ER_LOCK_DEADLOCK && _statistics)
+                        _statistics->RecordDeadlock(sql);
+
                     RollbackTransaction();
                     return errorCode;
                 }
@@ -589,21 +1150,26 @@ int32 MySQLConnection::ExecuteTransaction(SQLTransaction transaction)
     // This is done in calling functions DatabaseWorkerPool<T>::DirectCommitTransaction and TransactionTask::Execute,
     // and not while iterating over every element.
     CommitTransaction();
-    return 0;
-}
 
-std::size_t MySQLConnection::EscapeString(char* to, const char* from, std::size_t length)
-{
-    return mysql_real_escape_string(_mysqlHandle, to, from, length);
+    // Concurrent reads could cache the old rows again until the commit
+    if (_resultCache)
+        for (auto const& data : *queries)
+            if (data.type == SQL_ELEMENT_PREPARED)
+                _resultCache->Invalidate(*std::get<PreparedStatement>(data.element));
+
+    return 0;
 }
 
-void MySQLConnection::Ping()
+bool MySQLConnection::Ping()
 {
-    mysql_ping(_mysqlHandle);
+    return _mysqlHandle && !mysql_ping(_mysqlHandle);
 }
 
 int32 MySQLConnection::GetLastError()
 {
+    if (!_mysqlHandle)
+        return _lastError;
+
     return mysql_errno(_mysqlHandle);
 }
 
@@ -617,8 +1183,20 @@ bool MySQLConnection::CanRemoveConnection()
     if (!IsDynamic())
         return false;
 
+    // Worker can be parked until the server is back, don't block the pool on its destruction
+    if (!IsConnected())
+        return false;
+
     Milliseconds diff = std::chrono::duration_cast<Milliseconds>(std::chrono::system_clock::now() - _lastUseTime);
-    return diff >= DYNAMIC_CONNECTION_TIMEOUT;
+    if (diff < DYNAMIC_CONNECTION_TIMEOUT)
+        return false;
+
+    // Connection can still be in use, e.g by a streamed result set
+    if (!LockIfReady())
+        return false;
+
+    Unlock();
+    return true;
 }
 
 std::size_t MySQLConnection::GetQueueSize() const
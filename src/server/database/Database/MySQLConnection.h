@@ -20,17 +20,22 @@
 
 #include "DatabaseEnvFwd.h"
 #include "Duration.h"
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <thread>
 #include <vector>
 
-template <typename T>
-class ProducerConsumerQueue;
-
 class AsyncOperation;
+class AsyncOperationQueue;
 class AsyncDBQueueWorker;
+class DatabaseCircuitBreaker;
+class PreparedStatementRegistry;
+class QueryResultCache;
+class QueryStatistics;
 
 using PreparedStatementList = std::vector<std::unique_ptr<MySQLPreparedStatement>>;
 
@@ -49,13 +54,28 @@ struct WH_DATABASE_API MySQLConnectionInfo
 class WH_DATABASE_API MySQLConnection
 {
 public:
-    explicit MySQLConnection(MySQLConnectionInfo& connInfo, ProducerConsumerQueue<AsyncOperation*>* dbQueue, bool isDynamic = false);
+    explicit MySQLConnection(MySQLConnectionInfo& connInfo, AsyncOperationQueue* dbQueue, bool isDynamic = false);
     virtual ~MySQLConnection();
 
     virtual uint32 Open();
     void Close();
 
-    [[nodiscard]] bool PrepareStatements() const;
+    //! Opens a new session, statements are prepared again on their next execution
+    bool Reconnect();
+    [[nodiscard]] inline bool IsConnected() const { return _mysqlHandle != nullptr; }
+
+    //! Reconnects lost connection, waits for the server until the deadline while the circuit breaker is open
+    bool WaitForReconnect(TimePoint deadline);
+
+    //! Async operations are parked until the server is back, sync ones fail at once
+    [[nodiscard]] TimePoint GetParkDeadline(TimePoint since) const;
+
+    //! Lost connections reconnect with backoff shared by all connections of the pool
+    inline void SetCircuitBreaker(DatabaseCircuitBreaker* circuitBreaker) { _circuitBreaker = circuitBreaker; }
+
+    //! Notified by Unlock, callers of the pool wait on it for a free connection
+    inline void SetFreeCondition(std::condition_variable* condition) { _freeCondition = condition; }
+    [[nodiscard]] inline DatabaseCircuitBreaker* GetCircuitBreaker() const { return _circuitBreaker; }
 
     bool Execute(std::string_view sql);
     bool Execute(PreparedStatement stmt);
@@ -63,51 +83,125 @@ public:
     QueryResult Query(std::string_view sql);
     PreparedQueryResult Query(PreparedStatement stmt);
 
+    //! Sends all queries in one round trip, results are in the order of the queries.
+    //! Each query must be a single statement, results are mapped to the queries by position.
+    //! Result is nullptr for a query without rows, for a failed one and the ones after it.
+    std::vector<QueryResult> QueryMulti(std::vector<std::string_view> const& queries);
+
+    //! Executes statements of a script in one transaction, they are sent in batches of multiple statements.
+    //! Stops at the first failed statement and rolls back, statements which commit implicitly (DDL) stay executed.
+    bool ExecuteScript(std::vector<std::string_view> const& statements);
+
+    //! Server interrupts statements running longer, 0 disables the limit. Only SELECT statements are limited on MySQL.
+    //! Limit is rounded down to eight steps per power of two milliseconds, so similar deadlines don't change the session variable every time.
+    void SetStatementTimeLimit(Milliseconds limit);
+
+    //! Results are read from the server row by row instead of being buffered in client memory.
+    //! Connection must be locked by caller, the returned result set unlocks it when drained or destroyed.
+    QueryResult QueryStream(std::string_view sql);
+    PreparedQueryResult QueryStream(PreparedStatement stmt, uint32 prefetchRows);
+
+    //! Statement is prepared on the first call, nullptr if preparation failed
     MySQLPreparedStatement* GetPreparedStatement(uint32 index);
-    void PrepareStatement(uint32 index, std::string_view sql, ConnectionFlags flags);
 
-    inline PreparedStatementList* GetPreparedStatementList() { return &_stmtList; }
+    //! Statements are prepared on demand from the registry of the pool
+    inline void SetStatementRegistry(PreparedStatementRegistry const* registry) { _statementRegistry = registry; }
+    [[nodiscard]] inline uint32 GetPreparedStatementCount() const { return _preparedCount.load(std::memory_order_relaxed); }
+
+    //! Lost connection isn't retried statement by statement until the transaction ends, see HandleMySQLError
+    bool BeginTransaction();
+    bool RollbackTransaction();
+    bool CommitTransaction();
+
+    //! Connection has one savepoint, setting it again moves it to the current statement
+    bool SetSavepoint();
+    bool RollbackToSavepoint();
 
-    void BeginTransaction();
-    void RollbackTransaction();
-    void CommitTransaction();
     int32 ExecuteTransaction(SQLTransaction transaction);
-    std::size_t EscapeString(char* to, const char* from, std::size_t length);
-    void Ping();
+    bool Ping();
 
     int32 GetLastError();
 
-    /// Tries to acquire lock. If lock is acquired by another thread
-    /// the calling parent will just try another connection
-    inline bool LockIfReady() { return _mutex.try_lock(); }
+    /// Tries to acquire lock. If lock is acquired by another thread or the connection
+    /// still prepares its statements the calling parent will just try another connection
+    inline bool LockIfReady() { return IsReady() && _mutex.try_lock(); }
 
     /// Called by parent database pool. Will let other threads access this connection
-    inline void Unlock() { return _mutex.unlock(); }
+    inline void Unlock()
+    {
+        _mutex.unlock();
+
+        if (_freeCondition)
+            _freeCondition->notify_all();
+    }
 
     static std::string_view GetClientInfo();
     std::string_view GetServerInfo();
     [[nodiscard]] uint32 GetServerVersion() const;
 
+    //! Cached results depending on executed statements are invalidated
+    inline void SetResultCache(QueryResultCache* cache) { _resultCache = cache; }
+    [[nodiscard]] inline QueryResultCache* GetResultCache() const { return _resultCache; }
+
+    //! Executed queries are recorded, slow ones are logged
+    inline void SetStatistics(QueryStatistics* statistics) { _statistics = statistics; }
+    [[nodiscard]] inline QueryStatistics* GetStatistics() const { return _statistics; }
+
+    //! Connection is used by the pool once it's open and its statements are prepared, the async worker is started here
+    void SetReady();
+    [[nodiscard]] inline bool IsReady() const { return _ready.load(std::memory_order_acquire); }
+
     [[nodiscard]] inline bool IsDynamic() const { return _isDynamic; }
+
+    //! Lost replica connection isn't retried until the server stops, reads fall back to the primary instead
+    inline void SetReplica() { _isReplica = true; }
     [[nodiscard]] bool CanRemoveConnection();
     [[nodiscard]] std::size_t GetQueueSize() const;
 
 private:
-    bool Query(std::string_view sql, MySQLResult** result, MySQLField** fields, uint64* rowCount, uint32* fieldCount);
-    bool Query(PreparedStatement stmt, MySQLPreparedStatement** mysqlStmt, MySQLResult** pResult, uint64* pRowCount, uint32* pFieldCount);
-    bool HandleMySQLError(uint32 errNo, uint8 attempts = 5);
-    inline void UpdateLastUseTime() { _lastUseTime = std::chrono::system_clock::now(); }
+    bool Query(std::string_view sql, MySQLResult** result, MySQLField** fields, uint64* rowCount, uint32* fieldCount, bool streamed = false);
+    bool Query(PreparedStatement stmt, MySQLPreparedStatement** mysqlStmt, MySQLResult** pResult, uint64* pRowCount, uint32* pFieldCount, uint32 prefetchRows = 0);
+    bool HandleMySQLError(uint32 errNo);
+    void DrainResults();
+    bool SetMultiStatements(bool enable);
+    bool ExecuteStatement(std::string_view sql); ///< Without switching multiple statements off, for constant statements of the connection
+    bool ExecuteScriptBatch(std::string const& batch, std::vector<std::string_view> const& statements, std::size_t first, std::size_t count);
+    bool PrepareStatement(uint32 index);
+    bool CloseLeastUsedStatement();
+    void ClearPreparedStatements();
+    void RecordQuery(std::string_view sql, Microseconds time, bool error);
+    void RecordQuery(uint32 index, MySQLPreparedStatement const* stmt, Microseconds time, bool error);
+
+    inline void UpdateLastUseTime()
+    {
+        _lastUseTime = std::chrono::system_clock::now();
+        _retriesAfterReconnect = 0;
+    }
 
     MySQLHandle* _mysqlHandle{ nullptr };
     MySQLConnectionInfo& _connectionInfo;
     ConnectionFlags _connectionFlags{ ConnectionFlags::Sync };
     PreparedStatementList _stmtList;
+    PreparedStatementRegistry const* _statementRegistry{ nullptr };
+    std::atomic<uint32> _preparedCount{};
+    uint64 _statementUseCounter{};
     std::mutex _mutex;
+    std::atomic<bool> _ready{};
     bool _isDynamic{};
-    bool _prepareError{}; //! Was there any error while preparing statements?
+    bool _isReplica{};
+    bool _inTransaction{};
+    uint8 _retriesAfterReconnect{}; ///< Statement isn't retried forever if the server drops every new connection
+    uint32 _lastError{}; ///< Error of the lost connection, the handle is closed
+    uint32 _statementTimeLimit{}; ///< Milliseconds, set on the session of the current handle
+    bool _hasStatementTimeLimit{ true }; ///< False if the server doesn't support it
+    bool _multiStatements{}; ///< Left enabled by a batch of QueryMulti or ExecuteScript until a single query runs
     SystemTimePoint _lastUseTime;
-    ProducerConsumerQueue<AsyncOperation*>* _queue{ nullptr };
+    AsyncOperationQueue* _queue{ nullptr };
     std::unique_ptr<AsyncDBQueueWorker> _asyncQueueWorker;
+    QueryResultCache* _resultCache{ nullptr };
+    QueryStatistics* _statistics{ nullptr };
+    DatabaseCircuitBreaker* _circuitBreaker{ nullptr };
+    std::condition_variable* _freeCondition{ nullptr };
 
     MySQLConnection(MySQLConnection const& right) = delete;
     MySQLConnection& operator=(MySQLConnection const& right) = delete;
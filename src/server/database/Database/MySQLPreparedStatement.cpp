@@ -49,6 +49,8 @@ MySQLPreparedStatement::MySQLPreparedStatement(MySQLStmt* stmt, std::string_view
     _bind = new MySQLBind[_paramCount];
     memset(_bind, 0, sizeof(MySQLBind) * _paramCount);
 
+    _paramSlots = std::make_unique<ParameterSlot[]>(_paramCount);
+
     /// "If set to 1, causes mysql_stmt_store_result() to update the metadata MYSQL_FIELD->max_length value."
     auto bool_tmp = MySQLBool(1);
     mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &bool_tmp);
@@ -57,12 +59,6 @@ MySQLPreparedStatement::MySQLPreparedStatement(MySQLStmt* stmt, std::string_view
 MySQLPreparedStatement::~MySQLPreparedStatement()
 {
     ClearParameters();
-    if (_mysqlStmt->bind_result_done)
-    {
-        delete[] _mysqlStmt->bind->length;
-        delete[] _mysqlStmt->bind->is_null;
-    }
-
     mysql_stmt_close(_mysqlStmt);
     delete[] _bind;
 }
@@ -71,6 +67,10 @@ void MySQLPreparedStatement::BindParameters(PreparedStatement stmt)
 {
     _stmt = stmt; // Cross-reference them for debug output
 
+    PreparedStatementBinder binder(this);
+    if (stmt->BindParameters(binder))
+        return;
+
     uint8 pos = 0;
     for (PreparedStatementData const& data : stmt->GetParameters())
     {
@@ -90,14 +90,21 @@ void MySQLPreparedStatement::BindParameters(PreparedStatement stmt)
 
 void MySQLPreparedStatement::ClearParameters()
 {
+    // Buffers are owned by _paramSlots or by the bound statement
     for (uint32 i = 0; i < _paramCount; ++i)
     {
-        delete _bind[i].length;
         _bind[i].length = nullptr;
-        delete[] (char*)_bind[i].buffer;
         _bind[i].buffer = nullptr;
         _paramsSet[i] = false;
     }
+
+    _stmt.reset();
+}
+
+void MySQLPreparedStatement::Reset()
+{
+    if (mysql_stmt_reset(_mysqlStmt))
+        LOG_WARN("db.query", "Could not reset prepared statement: {}. Error: {}", _queryString, mysql_stmt_error(_mysqlStmt));
 }
 
 static bool ParamenterIndexAssertFail(uint32 stmtIndex, uint8 index, uint32 paramCount)
@@ -123,16 +130,15 @@ void MySQLPreparedStatement::SetParameter(const uint8 index, T value)
     AssertValidIndex(index);
     _paramsSet[index] = true;
     MYSQL_BIND* param = &_bind[index];
-    auto len = uint32(sizeof(T));
     param->buffer_type = MySQLType<T>::value;
-    delete[] static_cast<char*>(param->buffer);
-    param->buffer = new char[len];
+    param->buffer = &_paramSlots[index].Value;
     param->buffer_length = 0;
     param->is_null_value = 0;
     param->length = nullptr; // Only != NULL for strings
     param->is_unsigned = std::is_unsigned_v<T>;
 
-    memcpy(param->buffer, &value, len);
+    static_assert(sizeof(T) <= sizeof(ParameterSlot::Value));
+    memcpy(param->buffer, &value, sizeof(T));
 }
 
 void MySQLPreparedStatement::SetParameter(uint8 index, bool value)
@@ -146,29 +152,29 @@ void MySQLPreparedStatement::SetParameter(uint8 index, std::nullptr_t /*value*/)
     _paramsSet[index] = true;
     MYSQL_BIND* param = &_bind[index];
     param->buffer_type = MYSQL_TYPE_NULL;
-    delete[] static_cast<char*>(param->buffer);
     param->buffer = nullptr;
     param->buffer_length = 0;
     param->is_null_value = 1;
-    delete param->length;
     param->length = nullptr;
 }
 
 void MySQLPreparedStatement::SetParameter(uint8 index, std::string const& value)
+{
+    SetParameter(index, std::string_view{ value });
+}
+
+void MySQLPreparedStatement::SetParameter(uint8 index, std::string_view value)
 {
     AssertValidIndex(index);
     _paramsSet[index] = true;
     MYSQL_BIND* param = &_bind[index];
     auto len = uint32(value.size());
     param->buffer_type = MYSQL_TYPE_VAR_STRING;
-    delete[] static_cast<char*>(param->buffer);
-    param->buffer = new char[len];
+    param->buffer = const_cast<char*>(value.data());
     param->buffer_length = len;
     param->is_null_value = 0;
-    delete param->length;
-    param->length = new unsigned long(len);
-
-    memcpy(param->buffer, value.c_str(), len);
+    _paramSlots[index].Length = len;
+    param->length = &_paramSlots[index].Length;
 }
 
 void MySQLPreparedStatement::SetParameter(uint8 index, std::vector<uint8> const& value)
@@ -178,14 +184,11 @@ void MySQLPreparedStatement::SetParameter(uint8 index, std::vector<uint8> const&
     MYSQL_BIND* param = &_bind[index];
     auto len = uint32(value.size());
     param->buffer_type = MYSQL_TYPE_BLOB;
-    delete[] static_cast<char*>(param->buffer);
-    param->buffer = new char[len];
+    param->buffer = const_cast<uint8*>(value.data());
     param->buffer_length = len;
     param->is_null_value = 0;
-    delete param->length;
-    param->length = new unsigned long(len);
-
-    memcpy(param->buffer, value.data(), len);
+    _paramSlots[index].Length = len;
+    param->length = &_paramSlots[index].Length;
 }
 
 std::string MySQLPreparedStatement::getQueryString() const
@@ -193,18 +196,34 @@ std::string MySQLPreparedStatement::getQueryString() const
     std::string queryString(_queryString);
     std::size_t pos{};
 
-    for (PreparedStatementData const& data : _stmt->GetParameters())
+    if (!_stmt)
+        return queryString;
+
+    for (uint8 i = 0; i < _stmt->GetParameterCount(); ++i)
     {
         pos = queryString.find('?', pos);
+        if (pos == std::string::npos)
+            break;
 
-        std::string replaceStr = std::visit([&](auto&& data)
-        {
-            return PreparedStatementData::ToString(data);
-        }, data.data);
-
+        std::string replaceStr = _stmt->GetParameterString(i);
         queryString.replace(pos, 1, replaceStr);
         pos += replaceStr.length();
     }
 
     return queryString;
 }
+
+void PreparedStatementBinder::Bind(uint8 index, bool value) { _stmt->SetParameter(index, value); }
+void PreparedStatementBinder::Bind(uint8 index, uint8 value) { _stmt->SetParameter(index, value); }
+void PreparedStatementBinder::Bind(uint8 index, uint16 value) { _stmt->SetParameter(index, value); }
+void PreparedStatementBinder::Bind(uint8 index, uint32 value) { _stmt->SetParameter(index, value); }
+void PreparedStatementBinder::Bind(uint8 index, uint64 value) { _stmt->SetParameter(index, value); }
+void PreparedStatementBinder::Bind(uint8 index, int8 value) { _stmt->SetParameter(index, value); }
+void PreparedStatementBinder::Bind(uint8 index, int16 value) { _stmt->SetParameter(index, value); }
+void PreparedStatementBinder::Bind(uint8 index, int32 value) { _stmt->SetParameter(index, value); }
+void PreparedStatementBinder::Bind(uint8 index, int64 value) { _stmt->SetParameter(index, value); }
+void PreparedStatementBinder::Bind(uint8 index, float value) { _stmt->SetParameter(index, value); }
+void PreparedStatementBinder::Bind(uint8 index, double value) { _stmt->SetParameter(index, value); }
+void PreparedStatementBinder::Bind(uint8 index, std::string_view value) { _stmt->SetParameter(index, value); }
+void PreparedStatementBinder::Bind(uint8 index, std::vector<uint8> const& value) { _stmt->SetParameter(index, value); }
+void PreparedStatementBinder::Bind(uint8 index, std::nullptr_t value) { _stmt->SetParameter(index, value); }
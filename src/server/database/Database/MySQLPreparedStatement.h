@@ -20,6 +20,7 @@
 
 #include "DatabaseEnvFwd.h"
 #include "MySQLWorkaround.h"
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -32,6 +33,7 @@ class PreparedStatementBase;
 class WH_DATABASE_API MySQLPreparedStatement
 {
     friend class MySQLConnection;
+    friend class PreparedStatementBinder;
 
 public:
     MySQLPreparedStatement(MySQLStmt* stmt, std::string_view queryString);
@@ -45,6 +47,7 @@ protected:
     void SetParameter(uint8 index, bool value);
     void SetParameter(uint8 index, std::nullptr_t /*value*/);
     void SetParameter(uint8 index, std::string const& value);
+    void SetParameter(uint8 index, std::string_view value);
     void SetParameter(uint8 index, std::vector<uint8> const& value);
 
     template<typename T>
@@ -54,6 +57,9 @@ protected:
     MySQLBind* GetBind() { return _bind; }
     PreparedStatement _stmt;
     void ClearParameters();
+
+    //! Brings the statement back to its prepared state after a failed execution, the handle is reused without preparing it again
+    void Reset();
     void AssertValidIndex(uint8 index);
     [[nodiscard]] std::string getQueryString() const;
 
@@ -63,6 +69,17 @@ private:
     std::vector<bool> _paramsSet;
     MySQLBind* _bind{ nullptr };
     std::string _queryString;
+    uint64 _lastUse{}; ///< Use counter of the connection, least recently used statements are closed first
+
+    //- Preallocated storage of numeric values and lengths of bound parameters.
+    //- Strings and binaries are bound from the memory of PreparedStatementBase, which lives until the execution is done.
+    struct ParameterSlot
+    {
+        uint64 Value;
+        unsigned long Length;
+    };
+
+    std::unique_ptr<ParameterSlot[]> _paramSlots;
 
     MySQLPreparedStatement(MySQLPreparedStatement const& right) = delete;
     MySQLPreparedStatement& operator=(MySQLPreparedStatement const& right) = delete;
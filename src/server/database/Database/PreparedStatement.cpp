@@ -103,3 +103,23 @@ template WH_DATABASE_API std::string PreparedStatementData::ToString(std::string
 template WH_DATABASE_API std::string PreparedStatementData::ToString(float);
 template WH_DATABASE_API std::string PreparedStatementData::ToString(double);
 template WH_DATABASE_API std::string PreparedStatementData::ToString(bool);
+
+std::string PreparedStatementBase::GetParameterString(uint8 index) const
+{
+    ASSERT(index < _statementData.size());
+
+    return std::visit([](auto&& data)
+    {
+        return PreparedStatementData::ToString(data);
+    }, _statementData[index].data);
+}
+
+void PreparedStatementBase::AppendParameterKey(uint8 index, std::string& key) const
+{
+    ASSERT(index < _statementData.size());
+
+    std::visit([&key](auto&& data)
+    {
+        Warhead::Impl::AppendParameterKey(key, data);
+    }, _statementData[index].data);
+}
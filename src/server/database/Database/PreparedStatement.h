@@ -18,6 +18,7 @@
 #ifndef _PREPAREDSTATEMENT_H
 #define _PREPAREDSTATEMENT_H
 
+#include "DatabaseObjectPool.h"
 #include "Define.h"
 #include "Duration.h"
 #include <string>
@@ -38,6 +39,31 @@ namespace Warhead::Types
     using is_non_string_view_v = std::enable_if_t<!std::is_base_of_v<std::string_view, T>>;
 }
 
+namespace Warhead::Impl
+{
+    //! Appends a value to a result cache key. Values are prefixed by their size, so keys of parameter lists never collide.
+    template<typename T>
+    inline void AppendParameterKey(std::string& key, T const& value)
+    {
+        if constexpr (std::is_arithmetic_v<T>)
+        {
+            key.push_back(char(sizeof(T)));
+            key.append(reinterpret_cast<char const*>(&value), sizeof(T));
+        }
+        else if constexpr (std::is_same_v<T, std::nullptr_t>)
+            key.push_back('\0');
+        else
+        {
+            auto size = uint32(value.size());
+            key.push_back('s');
+            key.append(reinterpret_cast<char const*>(&size), sizeof(size));
+            key.append(reinterpret_cast<char const*>(value.data()), value.size());
+        }
+    }
+}
+
+class MySQLPreparedStatement;
+
 struct PreparedStatementData
 {
     std::variant<
@@ -63,6 +89,35 @@ struct PreparedStatementData
     static std::string ToString(std::nullptr_t /*value*/);
 };
 
+//- Sized by parameter count of the statement, allocated from the object pool
+using PreparedStatementDataList = std::vector<PreparedStatementData, DatabasePoolAllocator<PreparedStatementData>>;
+
+//- Binds parameter values straight to the MySQL statement of the connection, used by typed statements.
+//- Strings and binaries are not copied, they must live until the statement is executed.
+class WH_DATABASE_API PreparedStatementBinder
+{
+public:
+    explicit PreparedStatementBinder(MySQLPreparedStatement* stmt) : _stmt(stmt) { }
+
+    void Bind(uint8 index, bool value);
+    void Bind(uint8 index, uint8 value);
+    void Bind(uint8 index, uint16 value);
+    void Bind(uint8 index, uint32 value);
+    void Bind(uint8 index, uint64 value);
+    void Bind(uint8 index, int8 value);
+    void Bind(uint8 index, int16 value);
+    void Bind(uint8 index, int32 value);
+    void Bind(uint8 index, int64 value);
+    void Bind(uint8 index, float value);
+    void Bind(uint8 index, double value);
+    void Bind(uint8 index, std::string_view value);
+    void Bind(uint8 index, std::vector<uint8> const& value);
+    void Bind(uint8 index, std::nullptr_t /*value*/);
+
+private:
+    MySQLPreparedStatement* _stmt;
+};
+
 //- Upper-level class that is used in code
 class WH_DATABASE_API PreparedStatementBase
 {
@@ -119,8 +174,18 @@ public:
     }
 
     [[nodiscard]] uint32 GetIndex() const { return _index; }
-    [[nodiscard]] std::vector<PreparedStatementData> const& GetParameters() const { return _statementData; }
-    [[nodiscard]] std::pair<bool, uint8> IsAllParamsSet() const;
+    [[nodiscard]] PreparedStatementDataList const& GetParameters() const { return _statementData; }
+    [[nodiscard]] virtual std::pair<bool, uint8> IsAllParamsSet() const;
+
+    //! Typed statements bind their values by themselves, others are bound from GetParameters()
+    virtual bool BindParameters(PreparedStatementBinder& /*binder*/) const { return false; }
+
+    //! Used for query string output in logs
+    [[nodiscard]] virtual uint8 GetParameterCount() const { return uint8(_statementData.size()); }
+    [[nodiscard]] virtual std::string GetParameterString(uint8 index) const;
+
+    //! Used for result cache keys
+    virtual void AppendParameterKey(uint8 index, std::string& key) const;
 
 protected:
     template<typename T>
@@ -143,10 +208,10 @@ protected:
     }
 
     uint32 _index;
-    std::vector<bool> _paramsSet;
+    std::vector<bool, DatabasePoolAllocator<bool>> _paramsSet;
 
     //- Buffer of parameters, not tied to MySQL in any way yet
-    std::vector<PreparedStatementData> _statementData;
+    PreparedStatementDataList _statementData;
 
     PreparedStatementBase(PreparedStatementBase const& right) = delete;
     PreparedStatementBase& operator=(PreparedStatementBase const& right) = delete;
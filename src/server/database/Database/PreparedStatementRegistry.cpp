@@ -0,0 +1,58 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "PreparedStatementRegistry.h"
+#include <algorithm>
+
+bool PreparedStatementRegistry::Register(uint32 index, std::string_view sql, ConnectionFlags flags, std::optional<uint8> paramCount /*= {}*/)
+{
+    if (index >= _statements.size())
+        _statements.resize(index + 1);
+
+    auto& info = _statements[index];
+    if (info.IsRegistered)
+        return false;
+
+    info.Query = sql;
+    info.ConnectionType = flags;
+    info.DeclaredParamCount = paramCount;
+    info.ParamCount = paramCount.value_or(0);
+    info.IsRegistered = true;
+    return true;
+}
+
+void PreparedStatementRegistry::Resize(std::size_t size)
+{
+    if (size > _statements.size())
+        _statements.resize(size);
+}
+
+PreparedStatementInfo const* PreparedStatementRegistry::GetInfo(uint32 index) const
+{
+    if (index >= _statements.size() || !_statements[index].IsRegistered)
+        return nullptr;
+
+    return &_statements[index];
+}
+
+std::size_t PreparedStatementRegistry::GetRegisteredCount() const
+{
+    return std::count_if(_statements.begin(), _statements.end(), [](PreparedStatementInfo const& info) { return info.IsRegistered; });
+}
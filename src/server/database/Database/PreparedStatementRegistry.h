@@ -0,0 +1,72 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _PREPARED_STATEMENT_REGISTRY_H
+#define _PREPARED_STATEMENT_REGISTRY_H
+
+#include "DatabaseEnvFwd.h"
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct PreparedStatementInfo
+{
+    std::string Query;
+    ConnectionFlags ConnectionType{ ConnectionFlags::Sync };
+    std::optional<uint8> DeclaredParamCount; ///< Declared by typed statements, checked at preparation
+    uint8 ParamCount{}; ///< Known once the statement is validated against the server
+    bool IsRegistered{};
+};
+
+/**
+    Statements of one pool, indexed by statement index. Query and parameters are stored once here,
+    connections prepare a statement the first time it's executed on them and keep the handle.
+
+    Statements are registered in DoPrepareStatements, the registry is only read afterwards.
+*/
+class WH_DATABASE_API PreparedStatementRegistry
+{
+public:
+    PreparedStatementRegistry() = default;
+
+    //! Returns false if a statement is already registered with the index
+    bool Register(uint32 index, std::string_view sql, ConnectionFlags flags, std::optional<uint8> paramCount = {});
+    void Resize(std::size_t size);
+
+    //! Nullptr if no statement is registered with the index
+    [[nodiscard]] PreparedStatementInfo const* GetInfo(uint32 index) const;
+
+    [[nodiscard]] inline uint8 GetParamCount(uint32 index) const { return index < _statements.size() ? _statements[index].ParamCount : 0; }
+    inline void SetParamCount(uint32 index, uint8 paramCount) { _statements[index].ParamCount = paramCount; }
+
+    [[nodiscard]] inline std::size_t GetSize() const { return _statements.size(); }
+    [[nodiscard]] std::size_t GetRegisteredCount() const;
+
+    //! Limit of statements kept prepared by one connection, least recently used ones are closed. 0 is unlimited.
+    inline void SetMaxStatementsPerConnection(uint32 maxStatements) { _maxStatementsPerConnection = maxStatements; }
+    [[nodiscard]] inline uint32 GetMaxStatementsPerConnection() const { return _maxStatementsPerConnection; }
+
+private:
+    std::vector<PreparedStatementInfo> _statements;
+    uint32 _maxStatementsPerConnection{};
+
+    PreparedStatementRegistry(PreparedStatementRegistry const& right) = delete;
+    PreparedStatementRegistry& operator=(PreparedStatementRegistry const& right) = delete;
+};
+
+#endif
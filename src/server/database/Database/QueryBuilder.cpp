@@ -0,0 +1,76 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "QueryBuilder.h"
+
+std::size_t EscapeSQLString(char* to, char const* from, std::size_t length)
+{
+    char* out = to;
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        if (char escaped = GetSQLEscapeChar(from[i]))
+        {
+            *out++ = '\\';
+            *out++ = escaped;
+        }
+        else
+            *out++ = from[i];
+    }
+
+    *out = '\0';
+    return std::size_t(out - to);
+}
+
+void EscapeSQLString(std::string& str)
+{
+    std::size_t escapeCount{};
+
+    for (char c : str)
+        if (GetSQLEscapeChar(c))
+            ++escapeCount;
+
+    if (!escapeCount)
+        return;
+
+    // Escaped from the end, every character is moved once
+    std::size_t from = str.size();
+    std::size_t to = str.size() + escapeCount;
+    str.resize(to);
+
+    while (from != to)
+    {
+        char const c = str[--from];
+
+        if (char escaped = GetSQLEscapeChar(c))
+        {
+            str[--to] = escaped;
+            str[--to] = '\\';
+        }
+        else
+            str[--to] = c;
+    }
+}
+
+/*static*/ fmt::memory_buffer& QueryBuilder::GetBuffer()
+{
+    thread_local fmt::memory_buffer buffer;
+    return buffer;
+}
@@ -0,0 +1,109 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _QUERY_BUILDER_H
+#define _QUERY_BUILDER_H
+
+#include "Define.h"
+#include <fmt/format.h>
+#include <string>
+#include <string_view>
+
+//! Character written after the backslash when c is escaped, 0 if c is written as it is
+constexpr char GetSQLEscapeChar(char c)
+{
+    switch (c)
+    {
+        case '\0':   return '0';
+        case '\n':   return 'n';
+        case '\r':   return 'r';
+        case '\\':   return '\\';
+        case '\'':   return '\'';
+        case '"':    return '"';
+        case '\032': return 'Z';
+        default:     return 0;
+    }
+}
+
+//! Escapes like mysql_real_escape_string for the utf8/utf8mb4 connection charset, without a connection.
+//! Bytes of multibyte utf8 characters never match the escaped ASCII characters, so the string is escaped byte by byte.
+//! to must hold length * 2 + 1 bytes, it's null terminated. Returns the escaped length.
+//! Backslash escapes need a session without NO_BACKSLASH_ESCAPES, MySQLConnection::Open removes it from the sql_mode.
+WH_DATABASE_API std::size_t EscapeSQLString(char* to, char const* from, std::size_t length);
+
+//! Escapes in place, the string is only reallocated if it grows beyond its capacity
+WH_DATABASE_API void EscapeSQLString(std::string& str);
+
+//! Argument escaped while it's formatted, e.g. QueryBuilder::Format("... WHERE `name` = '{}'", SQLEscape{ name })
+struct SQLEscape
+{
+    std::string_view Value;
+};
+
+template<>
+struct fmt::formatter<SQLEscape> : fmt::formatter<std::string_view>
+{
+    template<typename FormatContext>
+    auto format(SQLEscape const& value, FormatContext& ctx) const -> decltype(ctx.out())
+    {
+        auto out = ctx.out();
+
+        for (char c : value.Value)
+        {
+            if (char escaped = GetSQLEscapeChar(c))
+            {
+                *out++ = '\\';
+                *out++ = escaped;
+            }
+            else
+                *out++ = c;
+        }
+
+        return out;
+    }
+};
+
+//! Formats ad hoc queries into a buffer owned by the calling thread, so building a query doesn't allocate in steady state
+class WH_DATABASE_API QueryBuilder
+{
+public:
+    //! Returned view is null terminated and valid until the thread formats the next query
+    template<typename... Args>
+    static std::string_view Format(std::string_view sql, Args&&... args)
+    {
+        fmt::memory_buffer& buffer = GetBuffer();
+        buffer.clear();
+
+        try
+        {
+            fmt::vformat_to(std::back_inserter(buffer), sql, fmt::make_format_args(args...));
+        }
+        catch (fmt::format_error const& formatError)
+        {
+            buffer.clear();
+            fmt::format_to(std::back_inserter(buffer), "An error occurred formatting string \"{}\": {}", sql, formatError.what());
+        }
+
+        buffer.push_back('\0');
+        return { buffer.data(), buffer.size() - 1 };
+    }
+
+private:
+    static fmt::memory_buffer& GetBuffer();
+};
+
+#endif
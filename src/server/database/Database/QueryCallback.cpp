@@ -19,215 +19,54 @@
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 
 #include "QueryCallback.h"
-#include "Duration.h"
 #include "Errors.h"
 
-template<typename T, typename... Args>
-inline void Construct(T& t, Args&&... args)
-{
-    new (&t) T(std::forward<Args>(args)...);
-}
-
-template<typename T>
-inline void Destroy(T& t)
-{
-    t.~T();
-}
-
-template<typename T>
-inline void ConstructActiveMember(T* obj)
-{
-    if (!obj->_isPrepared)
-        Construct(obj->_string);
-    else
-        Construct(obj->_prepared);
-}
-
-template<typename T>
-inline void DestroyActiveMember(T* obj)
-{
-    if (!obj->_isPrepared)
-        Destroy(obj->_string);
-    else
-        Destroy(obj->_prepared);
-}
-
-template<typename T>
-inline void MoveFrom(T* to, T&& from)
-{
-    ASSERT(to->_isPrepared == from._isPrepared);
-
-    if (!to->_isPrepared)
-        to->_string = std::move(from._string);
-    else
-        to->_prepared = std::move(from._prepared);
-}
-
-struct QueryCallback::QueryCallbackData
-{
-public:
-    friend class QueryCallback;
-
-    explicit QueryCallbackData(std::function<void(QueryCallback&, QueryResult)>&& callback) : _string(std::move(callback)), _isPrepared(false) { }
-    explicit QueryCallbackData(std::function<void(QueryCallback&, PreparedQueryResult)>&& callback) : _prepared(std::move(callback)), _isPrepared(true) { }
-
-    QueryCallbackData(QueryCallbackData&& right) noexcept
-    {
-        _isPrepared = right._isPrepared;
-        ConstructActiveMember(this);
-        MoveFrom(this, std::move(right));
-    }
-
-    QueryCallbackData& operator=(QueryCallbackData&& right) noexcept
-    {
-        if (this != &right)
-        {
-            if (_isPrepared != right._isPrepared)
-            {
-                DestroyActiveMember(this);
-                _isPrepared = right._isPrepared;
-                ConstructActiveMember(this);
-            }
-
-            MoveFrom(this, std::move(right));
-        }
-
-        return *this;
-    }
-
-    ~QueryCallbackData() { DestroyActiveMember(this); }
-
-private:
-    QueryCallbackData(QueryCallbackData const&) = delete;
-    QueryCallbackData& operator=(QueryCallbackData const&) = delete;
-
-    template<typename T> friend void ConstructActiveMember(T* obj);
-    template<typename T> friend void DestroyActiveMember(T* obj);
-    template<typename T> friend void MoveFrom(T* to, T&& from);
-
-    union
-    {
-        std::function<void(QueryCallback&, QueryResult)> _string;
-        std::function<void(QueryCallback&, PreparedQueryResult)> _prepared;
-    };
-
-    bool _isPrepared;
-};
+QueryCallback::QueryCallback(AsyncCompletionPtr completion) :
+    _completion(std::move(completion)) { }
 
-// Not using initialization lists to work around segmentation faults when compiling with clang without precompiled headers
-QueryCallback::QueryCallback(QueryResultFuture&& result)
+void QueryCallback::AddCallback(bool isPrepared, decltype(QueryCallbackData::Callback)&& callback)
 {
-    _isPrepared = false;
-    Construct(_string, std::move(result));
-}
-
-QueryCallback::QueryCallback(PreparedQueryResultFuture&& result)
-{
-    _isPrepared = true;
-    Construct(_prepared, std::move(result));
-}
-
-QueryCallback::QueryCallback(QueryCallback&& right) noexcept
-{
-    _isPrepared = right._isPrepared;
-    ConstructActiveMember(this);
-    _callbacks = std::move(right._callbacks);
-    MoveFrom(this, std::move(right));
-}
-
-QueryCallback& QueryCallback::operator=(QueryCallback&& right) noexcept
-{
-    if (this != &right)
+    if (!_callback.Callback && _chainedCallbacks.empty())
     {
-        if (_isPrepared != right._isPrepared)
-        {
-            DestroyActiveMember(this);
-            _isPrepared = right._isPrepared;
-            ConstructActiveMember(this);
-        }
+        ASSERT(isPrepared == _completion->IsPrepared(), "Attempted to set callback function for {} query on a {} async query",
+            isPrepared ? "prepared" : "string", _completion->IsPrepared() ? "prepared" : "string");
 
-        _callbacks = std::move(right._callbacks);
-        MoveFrom(this, std::move(right));
+        _callback = { isPrepared, std::move(callback) };
+        return;
     }
 
-    return *this;
-}
-
-QueryCallback::~QueryCallback()
-{
-    DestroyActiveMember(this);
-}
-
-QueryCallback&& QueryCallback::WithCallback(std::function<void(QueryResult)>&& callback)
-{
-    return WithChainingCallback([callback](QueryCallback& /*this*/, QueryResult result) { callback(std::move(result)); });
-}
-
-QueryCallback&& QueryCallback::WithPreparedCallback(std::function<void(PreparedQueryResult)>&& callback)
-{
-    return WithChainingPreparedCallback([callback](QueryCallback& /*this*/, PreparedQueryResult result) { callback(std::move(result)); });
-}
-
-QueryCallback&& QueryCallback::WithChainingCallback(std::function<void(QueryCallback&, QueryResult)>&& callback)
-{
-    ASSERT(!_callbacks.empty() || !_isPrepared, "Attempted to set callback function for string query on a prepared async query");
-    _callbacks.emplace(std::move(callback));
-    return std::move(*this);
-}
-
-QueryCallback&& QueryCallback::WithChainingPreparedCallback(std::function<void(QueryCallback&, PreparedQueryResult)>&& callback)
-{
-    ASSERT(!_callbacks.empty() || _isPrepared, "Attempted to set callback function for prepared query on a string async query");
-    _callbacks.emplace(std::move(callback));
-    return std::move(*this);
+    _chainedCallbacks.emplace_back(QueryCallbackData{ isPrepared, std::move(callback) });
 }
 
 void QueryCallback::SetNextQuery(QueryCallback&& next)
 {
-    MoveFrom(this, std::move(next));
+    _completion = std::move(next._completion);
 }
 
 bool QueryCallback::InvokeIfReady()
 {
-    QueryCallbackData& callback = _callbacks.front();
-    auto checkStateAndReturnCompletion = [this]()
-    {
-        _callbacks.pop();
-        bool hasNext = !_isPrepared ? _string.valid() : _prepared.valid();
-        if (_callbacks.empty())
-        {
-            ASSERT(!hasNext);
-            return true;
-        }
-
-        // abort chain
-        if (!hasNext)
-            return true;
-
-        ASSERT(_isPrepared == _callbacks.front()._isPrepared);
+    if (!_completion || !_completion->IsCompleted())
         return false;
-    };
 
-    if (!_isPrepared)
-    {
-        if (_string.valid() && _string.wait_for(0s) == std::future_status::ready)
-        {
-            QueryResultFuture f(std::move(_string));
-            std::function<void(QueryCallback&, QueryResult)> cb(std::move(callback._string));
-            cb(*this, f.get());
-            return checkStateAndReturnCompletion();
-        }
-    }
-    else
+    // Callback can set the next query of the chain
+    AsyncCompletionPtr completion = std::move(_completion);
+    auto callback = std::move(_callback.Callback);
+    callback(*this, *completion);
+
+    bool hasNext = static_cast<bool>(_completion);
+    if (_chainedCallbacks.empty())
     {
-        if (_prepared.valid() && _prepared.wait_for(0s) == std::future_status::ready)
-        {
-            PreparedQueryResultFuture f(std::move(_prepared));
-            std::function<void(QueryCallback&, PreparedQueryResult)> cb(std::move(callback._prepared));
-            cb(*this, f.get());
-            return checkStateAndReturnCompletion();
-        }
+        ASSERT(!hasNext);
+        return true;
     }
 
+    // abort chain
+    if (!hasNext)
+        return true;
+
+    _callback = std::move(_chainedCallbacks.front());
+    _chainedCallbacks.erase(_chainedCallbacks.begin());
+
+    ASSERT(_callback.IsPrepared == _completion->IsPrepared());
     return false;
 }
@@ -18,51 +18,75 @@
 #ifndef _QUERY_CALLBACK_H
 #define _QUERY_CALLBACK_H
 
+#include "AsyncCompletion.h"
 #include "DatabaseEnvFwd.h"
-#include <functional>
-#include <list>
-#include <queue>
+#include "InplaceFunction.h"
+#include <vector>
+
+//! Callables with bigger captures than this are allocated
+constexpr std::size_t QUERY_CALLBACK_INLINE_SIZE = 128;
 
 class WH_DATABASE_API QueryCallback
 {
 public:
-    explicit QueryCallback(QueryResultFuture&& result);
-    explicit QueryCallback(PreparedQueryResultFuture&& result);
+    explicit QueryCallback(AsyncCompletionPtr completion);
+
+    QueryCallback(QueryCallback&& right) noexcept = default;
+    QueryCallback& operator=(QueryCallback&& right) noexcept = default;
+    ~QueryCallback() = default;
 
-    QueryCallback(QueryCallback&& right) noexcept;
-    QueryCallback& operator=(QueryCallback&& right) noexcept;
-    ~QueryCallback();
+    template<typename Callback>
+    QueryCallback&& WithCallback(Callback&& callback)
+    {
+        return WithChainingCallback([callback = std::forward<Callback>(callback)](QueryCallback& /*this*/, QueryResult result) mutable { callback(std::move(result)); });
+    }
+
+    template<typename Callback>
+    QueryCallback&& WithPreparedCallback(Callback&& callback)
+    {
+        return WithChainingPreparedCallback([callback = std::forward<Callback>(callback)](QueryCallback& /*this*/, PreparedQueryResult result) mutable { callback(std::move(result)); });
+    }
 
-    QueryCallback&& WithCallback(std::function<void(QueryResult)>&& callback);
-    QueryCallback&& WithPreparedCallback(std::function<void(PreparedQueryResult)>&& callback);
+    template<typename Callback>
+    QueryCallback&& WithChainingCallback(Callback&& callback)
+    {
+        AddCallback(false, [callback = std::forward<Callback>(callback)](QueryCallback& self, AsyncCompletion& completion) mutable { callback(self, completion.TakeResult()); });
+        return std::move(*this);
+    }
 
-    QueryCallback&& WithChainingCallback(std::function<void(QueryCallback&, QueryResult)>&& callback);
-    QueryCallback&& WithChainingPreparedCallback(std::function<void(QueryCallback&, PreparedQueryResult)>&& callback);
+    template<typename Callback>
+    QueryCallback&& WithChainingPreparedCallback(Callback&& callback)
+    {
+        AddCallback(true, [callback = std::forward<Callback>(callback)](QueryCallback& self, AsyncCompletion& completion) mutable { callback(self, completion.TakePreparedResult()); });
+        return std::move(*this);
+    }
 
-    // Moves std::future from next to this object
+    // Moves completion from next to this object
     void SetNextQuery(QueryCallback&& next);
 
     // returns true when completed
     bool InvokeIfReady();
 
+    //! Callbacks aren't invoked, the query is dropped. Returns false if the query is already started, see AsyncCompletion::Cancel
+    inline bool Cancel() { return _completion->Cancel(); }
+
+    [[nodiscard]] inline AsyncCompletionPtr const& GetCompletion() const { return _completion; }
+
 private:
     QueryCallback(QueryCallback const& right) = delete;
     QueryCallback& operator=(QueryCallback const& right) = delete;
 
-    template<typename T> friend void ConstructActiveMember(T* obj);
-    template<typename T> friend void DestroyActiveMember(T* obj);
-    template<typename T> friend void MoveFrom(T* to, T&& from);
-
-    union
+    struct QueryCallbackData
     {
-        QueryResultFuture _string;
-        PreparedQueryResultFuture _prepared;
+        bool IsPrepared{};
+        Warhead::InplaceFunction<void(QueryCallback&, AsyncCompletion&), QUERY_CALLBACK_INLINE_SIZE> Callback;
     };
 
-    bool _isPrepared;
+    void AddCallback(bool isPrepared, decltype(QueryCallbackData::Callback)&& callback);
 
-    struct QueryCallbackData;
-    std::queue<QueryCallbackData, std::list<QueryCallbackData>> _callbacks;
+    AsyncCompletionPtr _completion;
+    QueryCallbackData _callback; ///< Invoked for the current query
+    std::vector<QueryCallbackData> _chainedCallbacks; ///< Invoked for the next queries, only chains allocate here
 };
 
 #endif // _QUERY_CALLBACK_H
@@ -0,0 +1,152 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "QueryCallbackProcessor.h"
+#include "Errors.h"
+
+AsyncCompletionQueue::~AsyncCompletionQueue()
+{
+    // Release the references held by queued completions, the queue itself would delete them
+    while (Pop()) { }
+}
+
+void AsyncCompletionQueue::Push(AsyncCompletion* completion)
+{
+    _queue.Enqueue(completion);
+    _size.fetch_add(1);
+
+    // Lock only if the consumer sleeps, see Wait
+    if (_waiting.load())
+    {
+        std::lock_guard guard(_mutex);
+        _condition.notify_one();
+    }
+}
+
+AsyncCompletionPtr AsyncCompletionQueue::Pop()
+{
+    AsyncCompletion* completion{ nullptr };
+    if (!_queue.Dequeue(completion))
+        return {};
+
+    _size.fetch_sub(1);
+    return AsyncCompletionPtr(completion, false);
+}
+
+void AsyncCompletionQueue::Wait(Milliseconds timeout)
+{
+    std::unique_lock lock(_mutex);
+
+    // Sequentially consistent with Push and Wake: either the producer sees _waiting or the consumer sees its change
+    _waiting.store(true);
+
+    _condition.wait_for(lock, timeout, [this]()
+    {
+        return _wakeRequested.load() || _size.load();
+    });
+
+    _waiting.store(false);
+    _wakeRequested.store(false);
+}
+
+void AsyncCompletionQueue::Wake()
+{
+    _wakeRequested.store(true);
+
+    if (_waiting.load())
+    {
+        std::lock_guard guard(_mutex);
+        _condition.notify_one();
+    }
+}
+
+void QueryCallbackProcessor::AddCallback(QueryCallback&& query)
+{
+    ASSERT(query.GetCompletion(), "Attempted to add a query callback without async query");
+
+    {
+        std::lock_guard guard(_addLock);
+        _added.emplace_back(std::move(query));
+    }
+
+    // Completion is subscribed by the processing thread, which gives the callback its slot
+    _completions.Wake();
+}
+
+void QueryCallbackProcessor::ProcessReadyCallbacks()
+{
+    MergeAddedCallbacks();
+
+    while (auto completion = _completions.Pop())
+    {
+        uint32 const slot = completion->GetCallbackSlot();
+        ASSERT(slot < _callbacks.size() && _callbacks[slot]);
+
+        QueryCallback& callback = *_callbacks[slot];
+
+        // Cancelled or expired query, its chained callbacks are dropped too
+        if (completion->IsCancelled())
+        {
+            _callbacks[slot].reset();
+            _freeSlots.emplace_back(slot);
+            continue;
+        }
+
+        if (!callback.InvokeIfReady())
+        {
+            // Chained query, wait for its own completion
+            ASSERT(callback.GetCompletion() && callback.GetCompletion() != completion);
+            callback.GetCompletion()->Subscribe(&_completions, slot);
+            continue;
+        }
+
+        _callbacks[slot].reset();
+        _freeSlots.emplace_back(slot);
+    }
+}
+
+void QueryCallbackProcessor::MergeAddedCallbacks()
+{
+    {
+        std::lock_guard guard(_addLock);
+        _added.swap(_merging);
+    }
+
+    for (QueryCallback& query : _merging)
+    {
+        uint32 slot{};
+
+        if (!_freeSlots.empty())
+        {
+            slot = _freeSlots.back();
+            _freeSlots.pop_back();
+        }
+        else
+        {
+            slot = static_cast<uint32>(_callbacks.size());
+            _callbacks.emplace_back();
+        }
+
+        _callbacks[slot].emplace(std::move(query));
+        _callbacks[slot]->GetCompletion()->Subscribe(&_completions, slot);
+    }
+
+    _merging.clear();
+}
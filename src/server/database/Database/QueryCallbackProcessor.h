@@ -0,0 +1,95 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _QUERY_CALLBACK_PROCESSOR_H
+#define _QUERY_CALLBACK_PROCESSOR_H
+
+#include "AsyncCompletion.h"
+#include "DatabaseEnvFwd.h"
+#include "Duration.h"
+#include "MPSCQueue.h"
+#include "QueryCallback.h"
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+//! Multiple producer, single consumer queue of completed queries. The consumer can sleep until something is pushed.
+class WH_DATABASE_API AsyncCompletionQueue
+{
+public:
+    AsyncCompletionQueue() = default;
+    ~AsyncCompletionQueue();
+
+    //! Takes over a reference to the completion
+    void Push(AsyncCompletion* completion);
+
+    //! Returns empty pointer if the queue is empty
+    AsyncCompletionPtr Pop();
+
+    //! Blocks until a completion is pushed, Wake is called or the timeout passes
+    void Wait(Milliseconds timeout);
+    void Wake();
+
+private:
+    MPSCQueue<AsyncCompletion, &AsyncCompletion::QueueLink> _queue;
+    std::atomic<uint32> _size{};
+    std::atomic<bool> _waiting{};
+    std::atomic<bool> _wakeRequested{};
+    std::mutex _mutex;
+    std::condition_variable _condition;
+
+    AsyncCompletionQueue(AsyncCompletionQueue const& right) = delete;
+    AsyncCompletionQueue& operator=(AsyncCompletionQueue const& right) = delete;
+};
+
+//! Invokes callbacks of async queries on the thread calling ProcessReadyCallbacks.
+//! Workers push completed queries to the processor, so processing costs O(completed) instead of polling every pending query.
+//! Pending callbacks are kept in reused slots, adding a callback doesn't allocate in steady state.
+class WH_DATABASE_API QueryCallbackProcessor
+{
+public:
+    QueryCallbackProcessor() = default;
+    ~QueryCallbackProcessor() = default;
+
+    //! Can be called from any thread. Callback functions must be set before, the callback can be invoked at once.
+    void AddCallback(QueryCallback&& query);
+
+    //! Must be called from one thread only
+    void ProcessReadyCallbacks();
+
+    //! Blocks the processing thread until a query completes, a callback is added, Wake is called or the timeout passes
+    inline void WaitForCompletion(Milliseconds timeout) { _completions.Wait(timeout); }
+    inline void Wake() { _completions.Wake(); }
+
+private:
+    void MergeAddedCallbacks();
+
+    AsyncCompletionQueue _completions;
+
+    std::mutex _addLock;
+    std::vector<QueryCallback> _added; ///< Added by any thread since the last processing
+    std::vector<QueryCallback> _merging; ///< Swapped with _added, keeps the capacity of both
+
+    std::vector<std::optional<QueryCallback>> _callbacks; ///< Indexed by callback slot of the completion
+    std::vector<uint32> _freeSlots;
+
+    QueryCallbackProcessor(QueryCallbackProcessor const&) = delete;
+    QueryCallbackProcessor& operator=(QueryCallbackProcessor const&) = delete;
+};
+
+#endif
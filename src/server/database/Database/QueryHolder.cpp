@@ -19,17 +19,24 @@
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 
 #include "QueryHolder.h"
-#include "Containers.h"
 #include "Log.h"
 #include "MySQLConnection.h"
 #include "PreparedStatement.h"
 #include "QueryResult.h"
 #include <utility>
 
+SQLQueryHolderQuery const* SQLQueryHolderBase::GetQuery(std::size_t index) const
+{
+    if (index >= _queries.size() || std::holds_alternative<std::monostate>(_queries[index].HolderQuery))
+        return nullptr;
+
+    return &_queries[index];
+}
+
 QueryResult SQLQueryHolderBase::GetResult(std::size_t index) const
 {
-    auto const& itr = _queries.find(index);
-    if (itr == _queries.end())
+    auto query = GetQuery(index);
+    if (!query)
     {
         LOG_ERROR("db.query", "Query holder result (QueryResult) tried to access non exist index {}", index);
         return nullptr;
@@ -37,7 +44,7 @@ QueryResult SQLQueryHolderBase::GetResult(std::size_t index) const
 
     try
     {
-        auto result{ std::get<QueryResult>(itr->second.HolderResult) };
+        auto result{ std::get<QueryResult>(query->HolderResult) };
         if (!result || !result->GetRowCount() || !result->NextRow())
             return nullptr;
 
@@ -50,8 +57,8 @@ QueryResult SQLQueryHolderBase::GetResult(std::size_t index) const
 
 PreparedQueryResult SQLQueryHolderBase::GetPreparedResult(std::size_t index) const
 {
-    auto const& itr = _queries.find(index);
-    if (itr == _queries.end())
+    auto query = GetQuery(index);
+    if (!query)
     {
         LOG_ERROR("db.query", "Query holder result (PreparedQueryResult) tried to access non exist index {}", index);
         return nullptr;
@@ -59,7 +66,7 @@ PreparedQueryResult SQLQueryHolderBase::GetPreparedResult(std::size_t index) con
 
     try
     {
-        auto result{ std::get<PreparedQueryResult>(itr->second.HolderResult) };
+        auto result{ std::get<PreparedQueryResult>(query->HolderResult) };
         if (!result || !result->GetRowCount())
             return nullptr;
 
@@ -76,8 +83,8 @@ void SQLQueryHolderBase::SetResult(std::size_t index, QueryResult result)
         result.reset();
 
     /// store the result in the holder
-    if (auto query = Warhead::Containers::MapGetValuePtr(_queries, index))
-        query->HolderResult = std::move(result);
+    if (index < _queries.size())
+        _queries[index].HolderResult = std::move(result);
 }
 
 void SQLQueryHolderBase::SetPreparedResult(std::size_t index, PreparedQueryResult result)
@@ -86,52 +93,93 @@ void SQLQueryHolderBase::SetPreparedResult(std::size_t index, PreparedQueryResul
         result.reset();
 
     /// store the result in the holder
-    if (auto query = Warhead::Containers::MapGetValuePtr(_queries, index))
-        query->HolderResult = std::move(result);
+    if (index < _queries.size())
+        _queries[index].HolderResult = std::move(result);
 }
 
 bool SQLQueryHolderBase::AddQuery(std::size_t index, std::string_view sql)
 {
-    if (_queries.contains(index))
+    if (GetQuery(index))
     {
         LOG_ERROR("db.query", "Query holder with index {} exist", index);
         return false;
     }
 
-    SQLQueryHolderQuery query{};
-    query.HolderQuery.emplace<std::string>(sql);
+    if (index >= _queries.size())
+        _queries.resize(index + 1);
 
-    _queries.emplace(index, std::move(query));
+    _queries[index].HolderQuery.emplace<std::string>(sql);
     return true;
 }
 
 bool SQLQueryHolderBase::AddPreparedQuery(std::size_t index, PreparedStatement stmt)
 {
-    if (_queries.contains(index))
+    if (GetQuery(index))
     {
         LOG_ERROR("db.query", "Query holder with index {} exist", index);
         return false;
     }
 
-    SQLQueryHolderQuery query{};
-    query.HolderQuery = std::move(stmt);
+    if (index >= _queries.size())
+        _queries.resize(index + 1);
 
-    _queries.emplace(index, std::move(query));
+    _queries[index].HolderQuery = std::move(stmt);
     return true;
 }
 
 void SQLQueryHolderTask::ExecuteQuery()
 {
+    std::vector<std::size_t> batchIndexes;
+    std::vector<std::string_view> batch;
+
+    // Consecutive string queries are sent in one round trip, order of the queries is kept
+    auto ExecuteBatch = [&]()
+    {
+        if (batch.size() == 1)
+            _holder->SetResult(batchIndexes.front(), _connection->Query(batch.front()));
+        else if (!batch.empty())
+        {
+            auto results = _connection->QueryMulti(batch);
+
+            for (std::size_t i{}; i < results.size(); ++i)
+            {
+                // Same semantic as Query, GetResult moves to the first row
+                _holder->SetResult(batchIndexes[i], std::move(results[i]));
+            }
+        }
+
+        batchIndexes.clear();
+        batch.clear();
+    };
+
     /// execute all queries in the holder and pass the results
-    for (auto const& [index, query] : _holder->_queries)
+    // Parts of a parallel execution write distinct elements, the vector isn't resized while it's executed
+    for (std::size_t index = _begin; index < _end; ++index)
     {
+        auto const& query = _holder->_queries[index];
+
         if (std::holds_alternative<std::string>(query.HolderQuery))
-            _holder->SetResult(index, _connection->Query(std::get<std::string>(query.HolderQuery)));
-        else
+        {
+            batchIndexes.emplace_back(index);
+            batch.emplace_back(std::get<std::string>(query.HolderQuery));
+        }
+        else if (std::holds_alternative<PreparedStatement>(query.HolderQuery))
+        {
+            ExecuteBatch();
             _holder->SetPreparedResult(index, _connection->Query(std::get<PreparedStatement>(query.HolderQuery)));
+        }
+    }
+
+    ExecuteBatch();
+
+    if (!_latch)
+    {
+        _result.set_value();
+        return;
     }
 
-    _result.set_value();
+    if (_latch->CountDown())
+        _latch->Result.set_value();
 }
 
 bool SQLQueryHolderCallback::InvokeIfReady()
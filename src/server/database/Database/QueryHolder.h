@@ -19,13 +19,14 @@
 #define _QUERYHOLDER_H
 
 #include "DatabaseAsyncOperation.h"
-#include "StringFormat.h"
-#include <unordered_map>
+#include "QueryBuilder.h"
+#include <atomic>
 #include <variant>
+#include <vector>
 
 struct SQLQueryHolderQuery
 {
-    std::variant<std::string, PreparedStatement> HolderQuery;
+    std::variant<std::monostate, std::string, PreparedStatement> HolderQuery; ///< Empty if no query was added with the index
     std::variant<QueryResult, PreparedQueryResult> HolderResult;
 };
 
@@ -37,6 +38,10 @@ public:
     SQLQueryHolderBase() = default;
     virtual ~SQLQueryHolderBase() = default;
 
+    //! Queries are stored by index, reserve the highest index + 1 if it's known
+    inline void SetSize(std::size_t size) { _queries.resize(size); }
+    [[nodiscard]] inline std::size_t GetSize() const { return _queries.size(); }
+
     [[nodiscard]] PreparedQueryResult GetPreparedResult(std::size_t index) const;
     [[nodiscard]] QueryResult GetResult(std::size_t index) const;
 
@@ -49,18 +54,36 @@ public:
     template<typename... Args>
     inline bool AddQuery(std::size_t index, std::string_view fmt, Args&&... args)
     {
-        return AddQuery(index, Warhead::StringFormat(fmt, std::forward<Args>(args)...));
+        return AddQuery(index, QueryBuilder::Format(fmt, std::forward<Args>(args)...));
     }
 
 private:
-    std::unordered_map<std::size_t, SQLQueryHolderQuery> _queries;
+    [[nodiscard]] SQLQueryHolderQuery const* GetQuery(std::size_t index) const;
+
+    std::vector<SQLQueryHolderQuery> _queries; ///< Indexed by query index, holder indexes are small and dense
+};
+
+//! Countdown shared by the parts of a holder executed in parallel, the last finished part completes the holder
+struct SQLQueryHolderLatch
+{
+    explicit SQLQueryHolderLatch(uint32 parts) : Remaining(parts) { }
+
+    //! True for the last part
+    inline bool CountDown() { return Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+    std::atomic<uint32> Remaining;
+    QueryResultHolderPromise Result;
 };
 
 class WH_DATABASE_API SQLQueryHolderTask : public AsyncOperation
 {
 public:
     explicit SQLQueryHolderTask(SQLQueryHolder holder) :
-        AsyncOperation(), _holder(std::move(holder)) { }
+        AsyncOperation(), _holder(std::move(holder)), _end(_holder->GetSize()) { }
+
+    //! Executes the queries [begin, end) of the holder, part of a parallel execution
+    SQLQueryHolderTask(SQLQueryHolder holder, std::shared_ptr<SQLQueryHolderLatch> latch, std::size_t begin, std::size_t end) :
+        AsyncOperation(), _holder(std::move(holder)), _latch(std::move(latch)), _begin(begin), _end(end) { }
 
     ~SQLQueryHolderTask() override = default;
 
@@ -70,6 +93,9 @@ public:
 private:
     std::shared_ptr<SQLQueryHolderBase> _holder;
     QueryResultHolderPromise _result;
+    std::shared_ptr<SQLQueryHolderLatch> _latch;
+    std::size_t _begin{};
+    std::size_t _end{};
 };
 
 class WH_DATABASE_API SQLQueryHolderCallback
@@ -21,10 +21,32 @@
 #include "QueryResult.h"
 #include "Errors.h"
 #include "Log.h"
+#include "MySQLConnection.h"
 #include "MySQLHacks.h"
 
 namespace
 {
+    //! Upper bound of the per column buffer for streamed results, longer values are fetched separately
+    constexpr uint32 STREAM_MAX_FIELD_BUFFER_SIZE = 4096;
+
+    bool IsVariableLengthType(enum_field_types type)
+    {
+        switch (type)
+        {
+            case MYSQL_TYPE_TINY_BLOB:
+            case MYSQL_TYPE_MEDIUM_BLOB:
+            case MYSQL_TYPE_LONG_BLOB:
+            case MYSQL_TYPE_BLOB:
+            case MYSQL_TYPE_STRING:
+            case MYSQL_TYPE_VAR_STRING:
+            case MYSQL_TYPE_DECIMAL:
+            case MYSQL_TYPE_NEWDECIMAL:
+                return true;
+            default:
+                return false;
+        }
+    }
+
     uint32 SizeForType(MYSQL_FIELD* field)
     {
         switch (field->type)
@@ -75,6 +97,87 @@ namespace
         }
     }
 
+    constexpr std::size_t AlignArena(std::size_t size)
+    {
+        return (size + 7) & ~std::size_t(7);
+    }
+
+    //! Size of the arena part with values of a column, variable length values are stored by offsets
+    std::size_t ColumnSizeForType(MYSQL_FIELD* field, uint64 rowCount)
+    {
+        std::size_t size = AlignArena(std::size_t(SizeForType(field)) * rowCount);
+
+        if (IsVariableLengthType(field->type))
+            size += AlignArena(sizeof(uint64) * (rowCount + 1));
+
+        return size;
+    }
+
+    //! Allocates the shared state of a PreparedResultData with its arena behind it, arena is set to the tail
+    template<typename T>
+    struct ResultArenaAllocator
+    {
+        using value_type = T;
+
+        ResultArenaAllocator(std::size_t arenaSize, char** arena) : ArenaSize(arenaSize), Arena(arena) { }
+
+        template<typename U>
+        ResultArenaAllocator(ResultArenaAllocator<U> const& right) : ArenaSize(right.ArenaSize), Arena(right.Arena) { }
+
+        T* allocate(std::size_t n)
+        {
+            std::size_t const stateSize = AlignArena(sizeof(T) * n);
+            char* memory = static_cast<char*>(::operator new(stateSize + ArenaSize));
+            *Arena = memory + stateSize;
+            return reinterpret_cast<T*>(memory);
+        }
+
+        void deallocate(T* ptr, std::size_t /*n*/)
+        {
+            ::operator delete(ptr);
+        }
+
+        template<typename U>
+        bool operator==(ResultArenaAllocator<U> const& right) const { return Arena == right.Arena; }
+
+        std::size_t ArenaSize;
+        char** Arena;
+    };
+
+    struct ResultBinds
+    {
+        MySQLBind* Bind;
+        unsigned long* Length;
+        MySQLBool* IsNull;
+    };
+
+    std::size_t ResultBindsSize(uint32 fieldCount)
+    {
+        return AlignArena(sizeof(MySQLBind) * fieldCount) + AlignArena(sizeof(unsigned long) * fieldCount) + AlignArena(sizeof(MySQLBool) * fieldCount);
+    }
+
+    ResultBinds CarveResultBinds(char* arena, uint32 fieldCount)
+    {
+        memset(arena, 0, ResultBindsSize(fieldCount));
+
+        ResultBinds binds{};
+        binds.Bind = reinterpret_cast<MySQLBind*>(arena);
+        arena += AlignArena(sizeof(MySQLBind) * fieldCount);
+        binds.Length = reinterpret_cast<unsigned long*>(arena);
+        arena += AlignArena(sizeof(unsigned long) * fieldCount);
+        binds.IsNull = reinterpret_cast<MySQLBool*>(arena);
+        return binds;
+    }
+
+    uint32 StreamSizeForType(MYSQL_FIELD* field)
+    {
+        // max_length is unknown without mysql_stmt_store_result, use the declared column length instead
+        if (IsVariableLengthType(field->type))
+            return std::min<uint32>(field->length, STREAM_MAX_FIELD_BUFFER_SIZE) + 1;
+
+        return SizeForType(field);
+    }
+
     DatabaseFieldTypes MysqlTypeToFieldType(enum_field_types type)
     {
         switch (type)
@@ -162,14 +265,17 @@ namespace
         meta->TypeName = FieldTypeToString(field->type);
         meta->Index = fieldIndex;
         meta->Type = MysqlTypeToFieldType(field->type);
+        meta->Unsigned = (field->flags & UNSIGNED_FLAG) != 0;
     }
 }
 
-ResultSet::ResultSet(MySQLResult* result, MySQLField* fields, uint64 rowCount, uint32 fieldCount) :
+ResultSet::ResultSet(MySQLResult* result, MySQLField* fields, uint64 rowCount, uint32 fieldCount, MySQLConnection* streamConnection /*= nullptr*/) :
     _rowCount(rowCount),
     _fieldCount(fieldCount),
     _result(result),
-    _fields(fields)
+    _fields(fields),
+    _streamConnection(streamConnection),
+    _streamed(streamConnection != nullptr)
 {
     _fieldMetadata.resize(_fieldCount);
     _currRow = std::make_unique<Field[]>(_fieldCount);
@@ -178,6 +284,10 @@ ResultSet::ResultSet(MySQLResult* result, MySQLField* fields, uint64 rowCount, u
     {
         InitializeDatabaseFieldMetadata(&_fieldMetadata[i], &_fields[i], i);
         _currRow[i].SetMetadata(&_fieldMetadata[i]);
+
+        // BIT values are sent as raw bytes even by the text protocol
+        if (_fields[i].type != MYSQL_TYPE_BIT && (_currRow[i].IsNumeric() || _currRow[i].IsType(DatabaseFieldTypes::Decimal)))
+            _numericFields.push_back(i);
     }
 }
 
@@ -209,6 +319,12 @@ bool ResultSet::NextRow()
     for (uint32 i = 0; i < _fieldCount; i++)
         _currRow[i].SetStructuredValue(row[i], lengths[i]);
 
+    for (uint32 i : _numericFields)
+        _currRow[i].DecodeNumericValue();
+
+    if (_streamed)
+        ++_rowCount;
+
     return true;
 }
 
@@ -222,9 +338,16 @@ void ResultSet::CleanUp()
 {
     if (_result)
     {
+        // For streamed results this also reads the rest of rows from the server
         mysql_free_result(_result);
         _result = nullptr;
     }
+
+    if (_streamConnection)
+    {
+        _streamConnection->Unlock();
+        _streamConnection = nullptr;
+    }
 }
 
 Field const& ResultSet::operator[](std::size_t index) const
@@ -238,6 +361,31 @@ void ResultSet::AssertRows(std::size_t sizeRows) const
     ASSERT(sizeRows == _fieldCount);
 }
 
+PreparedResultData::~PreparedResultData()
+{
+    std::destroy_n(FieldMetadata, FieldCount);
+}
+
+std::shared_ptr<PreparedResultData> PreparedResultData::Create(uint32 fieldCount, std::size_t valuesSize)
+{
+    std::size_t const metadataSize = AlignArena(sizeof(QueryResultFieldMetadata) * fieldCount);
+    std::size_t const columnsSize = AlignArena(sizeof(PreparedResultColumn) * fieldCount);
+
+    char* arena = nullptr;
+    auto data = std::allocate_shared<PreparedResultData>(ResultArenaAllocator<PreparedResultData>(metadataSize + columnsSize + valuesSize, &arena));
+
+    data->FieldMetadata = reinterpret_cast<QueryResultFieldMetadata*>(arena);
+    std::uninitialized_default_construct_n(data->FieldMetadata, fieldCount);
+    data->FieldCount = fieldCount;
+
+    data->Columns = reinterpret_cast<PreparedResultColumn*>(arena + metadataSize);
+    std::uninitialized_value_construct_n(data->Columns, fieldCount);
+
+    data->Values = arena + metadataSize + columnsSize;
+    data->ArenaSize = metadataSize + columnsSize + valuesSize;
+    return data;
+}
+
 PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint64 rowCount, uint32 fieldCount) :
     _rowCount(rowCount),
     _fieldCount(fieldCount),
@@ -247,125 +395,205 @@ PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint6
     if (!_metadataResult)
         return;
 
-    if (_stmt->bind_result_done)
-    {
-        delete[] _stmt->bind->length;
-        delete[] _stmt->bind->is_null;
-    }
-
-    _rBind = new MySQLBind[_fieldCount];
-
-    //- for future readers wondering where this is freed - mysql_stmt_bind_result moves pointers to these
-    // from m_rBind to m_stmt->bind and it is later freed by the `if (m_stmt->bind_result_done)` block just above here
-    // MYSQL_STMT lifetime is equal to connection lifetime
-    auto* isNull = new MySQLBool[_fieldCount];
-    auto* length = new unsigned long[_fieldCount];
-
-    memset(isNull, 0, sizeof(MySQLBool) * _fieldCount);
-    memset(_rBind, 0, sizeof(MySQLBind) * _fieldCount);
-    memset(length, 0, sizeof(unsigned long) * _fieldCount);
-
     //- This is where we store the (entire) resultset
     if (mysql_stmt_store_result(_stmt))
     {
         LOG_WARN("db.query", "{}:mysql_stmt_store_result, cannot bind result from MySQL server. Error: {}", __FUNCTION__, mysql_stmt_error(_stmt));
-        delete[] _rBind;
-        delete[] isNull;
-        delete[] length;
+        _rowCount = 0;
+        CleanUp();
         return;
     }
 
     _rowCount = mysql_stmt_num_rows(_stmt);
 
-    //- This is where we prepare the buffer based on metadata
+    //- Layout of the values: binds used while fetching, null mask and values of every column, then the row the binds point to
     auto* field = reinterpret_cast<MySQLField*>(mysql_fetch_fields(_metadataResult));
-    _fieldMetadata.resize(_fieldCount);
+    std::size_t const bindsSize = ResultBindsSize(_fieldCount);
+    std::size_t const nullMaskSize = AlignArena((_rowCount + 63) / 64 * sizeof(uint64));
+    std::size_t columnsSize = 0;
     std::size_t rowSize = 0;
 
     for (uint32 i = 0; i < _fieldCount; ++i)
     {
-        uint32 size = SizeForType(&field[i]);
-        rowSize += size;
+        columnsSize += nullMaskSize + ColumnSizeForType(&field[i], _rowCount);
+        rowSize += AlignArena(SizeForType(&field[i]));
+    }
 
-        InitializeDatabaseFieldMetadata(&_fieldMetadata[i], &field[i], i);
+    auto data = PreparedResultData::Create(_fieldCount, bindsSize + columnsSize + rowSize);
 
-        _rBind[i].buffer_type = field[i].type;
-        _rBind[i].buffer_length = size;
-        _rBind[i].length = &length[i];
-        _rBind[i].is_null = &isNull[i];
-        _rBind[i].error = nullptr;
-        _rBind[i].is_unsigned = field[i].flags & UNSIGNED_FLAG;
-    }
+    char* arena = data->Values;
+    ResultBinds binds = CarveResultBinds(arena, _fieldCount);
+    arena += bindsSize;
+    char* rowBuffer = arena + columnsSize;
 
-    char* dataBuffer = new char[rowSize * _rowCount];
-    for (uint32 i = 0, offset = 0; i < _fieldCount; ++i)
+    for (uint32 i = 0; i < _fieldCount; ++i)
     {
-        _rBind[i].buffer = dataBuffer + offset;
-        offset += _rBind[i].buffer_length;
+        InitializeDatabaseFieldMetadata(&data->FieldMetadata[i], &field[i], i);
+
+        auto& column = data->Columns[i];
+        uint32 size = SizeForType(&field[i]);
+
+        column.NullMask = reinterpret_cast<uint64*>(arena);
+        memset(column.NullMask, 0, nullMaskSize);
+        arena += nullMaskSize;
+
+        if (IsVariableLengthType(field[i].type))
+        {
+            column.Offsets = reinterpret_cast<uint64*>(arena);
+            column.Offsets[0] = 0;
+            arena += AlignArena(sizeof(uint64) * (_rowCount + 1));
+        }
+        else
+            column.Width = size;
+
+        column.Data = arena;
+        arena += AlignArena(std::size_t(size) * _rowCount);
+
+        binds.Bind[i].buffer_type = field[i].type;
+        binds.Bind[i].buffer = rowBuffer;
+        binds.Bind[i].buffer_length = size;
+        binds.Bind[i].length = &binds.Length[i];
+        binds.Bind[i].is_null = &binds.IsNull[i];
+        binds.Bind[i].error = nullptr;
+        binds.Bind[i].is_unsigned = field[i].flags & UNSIGNED_FLAG;
+
+        rowBuffer += AlignArena(size);
     }
 
     //- This is where we bind the bind the buffer to the statement
-    if (mysql_stmt_bind_result(_stmt, _rBind))
+    if (mysql_stmt_bind_result(_stmt, binds.Bind))
     {
         LOG_WARN("db.query", "{}:mysql_stmt_bind_result, cannot bind result from MySQL server. Error: {}", __FUNCTION__, mysql_stmt_error(_stmt));
         mysql_stmt_free_result(_stmt);
+        _rowCount = 0;
         CleanUp();
-        delete[] isNull;
-        delete[] length;
         return;
     }
 
-    _rows.resize(uint32(_rowCount) * _fieldCount);
-
-    while (_NextRow())
+    //- Every row is fetched into the same bound row and copied into the column storage
+    for (uint64 row = 0; row < _rowCount; ++row)
     {
-        for (uint32 fIndex = 0; fIndex < _fieldCount; ++fIndex)
+        int mysqlStmtFetch = mysql_stmt_fetch(_stmt);
+        if (mysqlStmtFetch != 0 && mysqlStmtFetch != MYSQL_DATA_TRUNCATED)
         {
-            _rows[uint32(_rowPosition) * _fieldCount + fIndex].SetMetadata(&_fieldMetadata[fIndex]);
+            LOG_WARN("db.query", "{}:mysql_stmt_fetch, cannot fetch row {} from MySQL server. Error: {}", __FUNCTION__, row, mysql_stmt_error(_stmt));
+            _rowCount = row;
+            data->Truncated = true;
+            break;
+        }
 
-            unsigned long buffer_length = _rBind[fIndex].buffer_length;
-            unsigned long fetched_length = *_rBind[fIndex].length;
-            if (!*_rBind[fIndex].is_null)
-            {
-                void* buffer = _stmt->bind[fIndex].buffer;
-                switch (_rBind[fIndex].buffer_type)
-                {
-                    case MYSQL_TYPE_TINY_BLOB:
-                    case MYSQL_TYPE_MEDIUM_BLOB:
-                    case MYSQL_TYPE_LONG_BLOB:
-                    case MYSQL_TYPE_BLOB:
-                    case MYSQL_TYPE_STRING:
-                    case MYSQL_TYPE_VAR_STRING:
-                        // warning - the string will not be null-terminated if there is no space for it in the buffer
-                        // when mysql_stmt_fetch returned MYSQL_DATA_TRUNCATED
-                        // we cannot blindly null-terminate the data either as it may be retrieved as binary blob and not specifically a string
-                        // in this case using Field::GetCString will result in garbage
-                        // TODO: remove Field::GetCString and use std::string_view in C++17
-                        if (fetched_length < buffer_length)
-                            *((char*)buffer + fetched_length) = '\0';
-                        break;
-                    default:
-                        break;
-                }
+        for (uint32 i = 0; i < _fieldCount; ++i)
+        {
+            auto const& column = data->Columns[i];
+            auto const* value = static_cast<char const*>(binds.Bind[i].buffer);
+            bool isNull = binds.IsNull[i];
 
-                _rows[uint32(_rowPosition) * _fieldCount + fIndex].SetByteValue((char const*)buffer, fetched_length);
+            if (isNull)
+                column.NullMask[row / 64] |= uint64(1) << (row % 64);
 
-                // move buffer pointer to next part
-                _stmt->bind[fIndex].buffer = (char*)buffer + rowSize;
-            }
-            else
+            if (!column.IsVariableLength())
             {
-                _rows[uint32(_rowPosition) * _fieldCount + fIndex].SetByteValue(nullptr, *_rBind[fIndex].length);
+                if (isNull)
+                    memset(column.Data + row * column.Width, 0, column.Width);
+                else
+                    memcpy(column.Data + row * column.Width, value, column.Width);
+
+                continue;
             }
+
+            // Values are null terminated, buffers are sized by max_length + 1 so there is always space for it
+            uint64 offset = column.Offsets[row];
+            uint64 length = isNull ? 0 : std::min<uint64>(binds.Length[i], binds.Bind[i].buffer_length - 1);
+            memcpy(column.Data + offset, value, length);
+            column.Data[offset + length] = '\0';
+            column.Offsets[row + 1] = offset + length + 1;
         }
+    }
+
+    /// All data is buffered, let go of mysql c api structures.
+    /// Binds of the statement still point into the arena, every result set binds its own buffers before it fetches.
+    mysql_stmt_free_result(_stmt);
+    mysql_free_result(_metadataResult);
+    _metadataResult = nullptr;
+
+    data->RowCount = _rowCount;
+    _data = std::move(data);
 
-        _rowPosition++;
+    InitFields();
+
+    if (_rowCount)
+        SetCurrentRow();
+}
+
+PreparedResultSet::PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint32 fieldCount, MySQLConnection* streamConnection) :
+    _rowCount(0),
+    _fieldCount(fieldCount),
+    _stmt(stmt),
+    _metadataResult(result),
+    _streamConnection(streamConnection),
+    _streamed(true)
+{
+    if (!_metadataResult)
+    {
+        CleanUp();
+        return;
     }
 
-    _rowPosition = 0;
+    //- Only one row is kept in memory, rows are fetched from the server cursor by prefetch blocks
+    auto* field = reinterpret_cast<MySQLField*>(mysql_fetch_fields(_metadataResult));
+    std::size_t const bindsSize = ResultBindsSize(_fieldCount);
+    std::size_t rowSize = 0;
+
+    for (uint32 i = 0; i < _fieldCount; ++i)
+        rowSize += StreamSizeForType(&field[i]);
 
-    /// All data is buffered, let go of mysql c api structures
-    mysql_stmt_free_result(_stmt);
+    _streamArena.reset(new char[bindsSize + rowSize]);
+    ResultBinds binds = CarveResultBinds(_streamArena.get(), _fieldCount);
+    char* rowBuffer = _streamArena.get() + bindsSize;
+
+    auto data = PreparedResultData::Create(_fieldCount, 0);
+
+    for (uint32 i = 0; i < _fieldCount; ++i)
+    {
+        InitializeDatabaseFieldMetadata(&data->FieldMetadata[i], &field[i], i);
+
+        uint32 size = StreamSizeForType(&field[i]);
+
+        binds.Bind[i].buffer_type = field[i].type;
+        binds.Bind[i].buffer = rowBuffer;
+        binds.Bind[i].buffer_length = size;
+        binds.Bind[i].length = &binds.Length[i];
+        binds.Bind[i].is_null = &binds.IsNull[i];
+        binds.Bind[i].error = nullptr;
+        binds.Bind[i].is_unsigned = field[i].flags & UNSIGNED_FLAG;
+
+        rowBuffer += size;
+    }
+
+    _rBind = binds.Bind;
+    _data = std::move(data);
+    _streamOverflow.resize(_fieldCount);
+
+    InitFields();
+
+    if (mysql_stmt_bind_result(_stmt, _rBind))
+    {
+        LOG_WARN("db.query", "{}:mysql_stmt_bind_result, cannot bind result from MySQL server. Error: {}", __FUNCTION__, mysql_stmt_error(_stmt));
+        CleanUp();
+    }
+}
+
+PreparedResultSet::PreparedResultSet(std::shared_ptr<PreparedResultData const> data) :
+    _data(std::move(data)),
+    _rowCount(_data->RowCount),
+    _fieldCount(_data->FieldCount),
+    _stmt(nullptr),
+    _metadataResult(nullptr)
+{
+    InitFields();
+
+    if (_rowCount)
+        SetCurrentRow();
 }
 
 PreparedResultSet::~PreparedResultSet()
@@ -375,48 +603,161 @@ PreparedResultSet::~PreparedResultSet()
 
 bool PreparedResultSet::NextRow()
 {
-    /// Only updates the m_rowPosition so upper level code knows in which element
-    /// of the rows vector to look
+    if (_streamed)
+        return NextStreamedRow();
+
+    /// Only updates the _rowPosition and points the fields to the values of the new row
     if (++_rowPosition >= _rowCount)
         return false;
 
+    SetCurrentRow();
     return true;
 }
 
-bool PreparedResultSet::_NextRow()
+void PreparedResultSet::InitFields()
+{
+    _currRow = std::make_unique<Field[]>(_fieldCount);
+
+    for (uint32 i = 0; i < _fieldCount; ++i)
+        _currRow[i].SetMetadata(&_data->FieldMetadata[i]);
+}
+
+void PreparedResultSet::SetCurrentRow()
+{
+    for (uint32 i = 0; i < _fieldCount; ++i)
+    {
+        auto const& column = _data->Columns[i];
+
+        if (column.IsNull(_rowPosition))
+            _currRow[i].SetByteValue(nullptr, 0);
+        else if (column.IsVariableLength())
+        {
+            char const* value = column.Data + column.Offsets[_rowPosition];
+            auto length = uint32(column.Offsets[_rowPosition + 1] - column.Offsets[_rowPosition] - 1);
+
+            // Decimals are sent as text by the binary protocol too
+            if (_data->FieldMetadata[i].Type == DatabaseFieldTypes::Decimal)
+                _currRow[i].SetStructuredValue(value, length);
+            else
+                _currRow[i].SetByteValue(value, length);
+        }
+        else
+            _currRow[i].SetByteValue(column.Data + _rowPosition * column.Width, column.Width);
+    }
+}
+
+bool PreparedResultSet::NextStreamedRow()
 {
-    /// Only called in low-level code, namely the constructor
-    /// Will iterate over every row of data and buffer it
-    if (_rowPosition >= _rowCount)
+    /// Streamed results reuse the single row buffer, _rowPosition always stays 0
+    if (!_rBind)
         return false;
 
     int mysqlStmtFetch = mysql_stmt_fetch(_stmt);
-    return mysqlStmtFetch == 0 || mysqlStmtFetch == MYSQL_DATA_TRUNCATED;
+    if (mysqlStmtFetch != 0 && mysqlStmtFetch != MYSQL_DATA_TRUNCATED)
+    {
+        if (mysqlStmtFetch != MYSQL_NO_DATA)
+            LOG_WARN("db.query", "{}:mysql_stmt_fetch, cannot fetch row from MySQL server. Error: {}", __FUNCTION__, mysql_stmt_error(_stmt));
+
+        CleanUp();
+        return false;
+    }
+
+    for (uint32 fIndex = 0; fIndex < _fieldCount; ++fIndex)
+    {
+        if (*_rBind[fIndex].is_null)
+        {
+            _currRow[fIndex].SetByteValue(nullptr, *_rBind[fIndex].length);
+            continue;
+        }
+
+        char* buffer = static_cast<char*>(_rBind[fIndex].buffer);
+        unsigned long buffer_length = _rBind[fIndex].buffer_length;
+        unsigned long fetched_length = *_rBind[fIndex].length;
+
+        if (IsVariableLengthType(_rBind[fIndex].buffer_type))
+        {
+            if (fetched_length >= buffer_length)
+            {
+                // Value was truncated, fetch the whole column into the overflow buffer
+                auto& overflow = _streamOverflow[fIndex];
+                overflow.resize(fetched_length + 1);
+
+                MySQLBind bind{};
+                unsigned long overflowLength{};
+                bind.buffer_type = _rBind[fIndex].buffer_type;
+                bind.buffer = overflow.data();
+                bind.buffer_length = fetched_length;
+                bind.length = &overflowLength;
+
+                if (mysql_stmt_fetch_column(_stmt, &bind, fIndex, 0))
+                {
+                    LOG_WARN("db.query", "{}:mysql_stmt_fetch_column, cannot fetch column {} from MySQL server. Error: {}", __FUNCTION__, fIndex, mysql_stmt_error(_stmt));
+                    CleanUp();
+                    return false;
+                }
+
+                buffer = overflow.data();
+            }
+
+            buffer[fetched_length] = '\0';
+        }
+
+        // Decimals are sent as text by the binary protocol too
+        if (_data->FieldMetadata[fIndex].Type == DatabaseFieldTypes::Decimal)
+            _currRow[fIndex].SetStructuredValue(buffer, fetched_length);
+        else
+            _currRow[fIndex].SetByteValue(buffer, fetched_length);
+    }
+
+    ++_rowCount;
+    return true;
 }
 
 Field* PreparedResultSet::Fetch() const
 {
     ASSERT(_rowPosition < _rowCount);
-    return const_cast<Field*>(&_rows[uint32(_rowPosition) * _fieldCount]);
+    return _currRow.get();
 }
 
 Field const& PreparedResultSet::operator[](std::size_t index) const
 {
     ASSERT(_rowPosition < _rowCount);
     ASSERT(index < _fieldCount);
-    return _rows[uint32(_rowPosition) * _fieldCount + index];
+    return _currRow[index];
+}
+
+PreparedResultColumn const* PreparedResultSet::GetColumnStorage(uint32 index, uint32 width) const
+{
+    ASSERT(!_streamed, "> Column access is not available for streamed results");
+    ASSERT(_data && index < _fieldCount);
+
+    auto const& column = _data->Columns[index];
+    ASSERT(width ? column.Width == width : column.IsVariableLength(), "> Incorrect type for column {} ({}.{}, {})",
+        index, _data->FieldMetadata[index].TableName, _data->FieldMetadata[index].Name, _data->FieldMetadata[index].TypeName);
+
+    return &column;
 }
 
 void PreparedResultSet::CleanUp()
 {
     if (_metadataResult)
+    {
         mysql_free_result(_metadataResult);
+        _metadataResult = nullptr;
+    }
 
     if (_rBind)
     {
-        delete[] (char*)_rBind->buffer;
-        delete[] _rBind;
+        // Closes the server side cursor of a streamed result
+        mysql_stmt_free_result(_stmt);
         _rBind = nullptr;
+        _streamArena.reset();
+    }
+
+    if (_streamConnection)
+    {
+        _streamConnection->Unlock();
+        _streamConnection = nullptr;
     }
 }
 
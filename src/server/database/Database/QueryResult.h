@@ -20,6 +20,8 @@
 
 #include "DatabaseEnvFwd.h"
 #include "Field.h"
+#include <memory>
+#include <optional>
 #include <unordered_map>
 
 template<typename T>
@@ -46,11 +48,16 @@ private:
 class WH_DATABASE_API ResultSet
 {
 public:
-    ResultSet(MySQLResult* result, MySQLField* fields, uint64 rowCount, uint32 fieldCount);
+    //! If streamConnection is set the rows are read from the server one by one (mysql_use_result)
+    //! and the connection stays locked until the result is drained or destroyed.
+    ResultSet(MySQLResult* result, MySQLField* fields, uint64 rowCount, uint32 fieldCount, MySQLConnection* streamConnection = nullptr);
     ~ResultSet();
 
     bool NextRow();
+
+    //! For streamed results this is the count of rows fetched so far
     [[nodiscard]] uint64 GetRowCount() const { return _rowCount; }
+    [[nodiscard]] bool IsStreamed() const { return _streamed; }
     [[nodiscard]] uint32 GetFieldCount() const { return _fieldCount; }
     [[nodiscard]] std::string GetFieldName(uint32 index) const;
 
@@ -73,6 +80,34 @@ public:
         return theTuple;
     }
 
+    //! Decodes the current and all following rows into structs described by a RowSchema.
+    //! Column types are validated once, returns false and logs the mismatch if they don't fit the schema.
+    template<typename Schema>
+    bool FetchRows(std::vector<typename Schema::Row>& rows)
+    {
+        if (!Schema::Validate(_fieldMetadata.data(), _fieldCount, false))
+            return false;
+
+        rows.reserve(rows.size() + (_streamed ? 0 : _rowCount));
+        do
+        {
+            Schema::Decode(_currRow.get(), rows.emplace_back());
+        } while (NextRow());
+
+        return true;
+    }
+
+    //! Returns std::nullopt if the column types don't fit the schema
+    template<typename Schema>
+    std::optional<std::vector<typename Schema::Row>> FetchRows()
+    {
+        std::vector<typename Schema::Row> rows;
+        if (!FetchRows<Schema>(rows))
+            return std::nullopt;
+
+        return rows;
+    }
+
     auto begin()      { return ResultIterator<ResultSet>(this); }
     static auto end() { return ResultIterator<ResultSet>(nullptr); }
 
@@ -88,21 +123,107 @@ private:
 
     MySQLResult* _result;
     MySQLField* _fields;
+    MySQLConnection* _streamConnection;
+    bool _streamed;
+    std::vector<uint32> _numericFields; ///< Columns decoded from text once per fetched row
 
     ResultSet(ResultSet const& right) = delete;
     ResultSet& operator=(ResultSet const& right) = delete;
 };
 
+//! Column of a buffered prepared result. Fixed width values are stored packed, variable length values
+//! (strings, blobs, decimals) as null terminated bytes addressed by offsets. Memory is owned by PreparedResultData.
+struct PreparedResultColumn
+{
+    char* Data{ nullptr };
+    uint64* Offsets{ nullptr };  ///< Variable length columns only, value of row N is [Offsets[N], Offsets[N + 1] - 1)
+    uint64* NullMask{ nullptr }; ///< One bit per row
+    uint32 Width{};                    ///< Size of a fixed width value
+
+    [[nodiscard]] inline bool IsVariableLength() const { return Offsets != nullptr; }
+    [[nodiscard]] inline bool IsNull(uint64 row) const { return (NullMask[row / 64] >> (row % 64)) & 1; }
+};
+
+//! Row data of a buffered prepared result. Metadata, columns and values are stored in one arena,
+//! the arena is allocated together with the shared state by Create.
+struct WH_DATABASE_API PreparedResultData
+{
+    PreparedResultData() = default;
+    ~PreparedResultData();
+
+    //! Constructs metadata and columns of fieldCount fields in the arena, valuesSize bytes for the values follow them
+    static std::shared_ptr<PreparedResultData> Create(uint32 fieldCount, std::size_t valuesSize);
+
+    QueryResultFieldMetadata* FieldMetadata{ nullptr };
+    PreparedResultColumn* Columns{ nullptr };
+    uint32 FieldCount{};
+    char* Values{ nullptr };
+    std::size_t ArenaSize{}; ///< Metadata, columns and values
+    uint64 RowCount{};
+    bool Truncated{}; ///< Fetch failed, not all rows were read
+
+    PreparedResultData(PreparedResultData const& right) = delete;
+    PreparedResultData& operator=(PreparedResultData const& right) = delete;
+};
+
+//! Typed zero-copy view of a column of a buffered prepared result.
+//! Arithmetic types must have the width of the column (e.g. uint32 for INT), std::string_view is used for strings, blobs and decimals.
+//! The view is valid as long as the result set is alive.
+template<typename T>
+class ResultColumn
+{
+    static_assert(std::is_arithmetic_v<T> || std::is_same_v<T, std::string_view>, "Unsupported type for ResultColumn");
+
+public:
+    explicit ResultColumn(PreparedResultColumn const* column, uint64 rowCount) : _column(column), _rowCount(rowCount) { }
+
+    [[nodiscard]] uint64 size() const { return _rowCount; }
+    [[nodiscard]] bool IsNull(uint64 row) const { return _column->IsNull(row); }
+
+    //! Null values are returned as 0 or empty string
+    [[nodiscard]] T operator[](uint64 row) const
+    {
+        if constexpr (std::is_same_v<T, std::string_view>)
+            return { _column->Data + _column->Offsets[row], std::size_t(_column->Offsets[row + 1] - _column->Offsets[row] - 1) };
+        else
+            return reinterpret_cast<T const*>(_column->Data)[row];
+    }
+
+    //! Packed values of fixed width columns
+    template<typename U = T>
+    [[nodiscard]] std::enable_if_t<std::is_arithmetic_v<U>, U const*> data() const
+    {
+        return reinterpret_cast<U const*>(_column->Data);
+    }
+
+private:
+    PreparedResultColumn const* _column;
+    uint64 _rowCount;
+};
+
 class WH_DATABASE_API PreparedResultSet
 {
 public:
     PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint64 rowCount, uint32 fieldCount);
+
+    //! Streamed result set, the statement must be executed with a read only cursor.
+    //! Only one row is held in client memory, the connection stays locked until the result is drained or destroyed.
+    PreparedResultSet(MySQLStmt* stmt, MySQLResult* result, uint32 fieldCount, MySQLConnection* streamConnection);
+
+    //! Result set over already buffered rows, e.g. a snapshot from the result cache
+    explicit PreparedResultSet(std::shared_ptr<PreparedResultData const> data);
     ~PreparedResultSet();
 
     bool NextRow();
+
+    //! For streamed results this is the count of rows fetched so far
     [[nodiscard]] uint64 GetRowCount() const { return _rowCount; }
+    [[nodiscard]] bool IsStreamed() const { return _streamed; }
     [[nodiscard]] uint32 GetFieldCount() const { return _fieldCount; }
 
+    //! Rows of a buffered result, can be shared by several result sets
+    [[nodiscard]] std::shared_ptr<PreparedResultData const> const& GetData() const { return _data; }
+
     [[nodiscard]] Field* Fetch() const;
     Field const& operator[](std::size_t index) const;
 
@@ -116,30 +237,74 @@ public:
         std::apply([this](Ts&... args)
         {
             uint8 index{ 0 };
-            ((args = _rows[uint32(_rowPosition) * _fieldCount + index].Get<Ts>(), index++), ...);
+            ((args = _currRow[index].Get<Ts>(), index++), ...);
         }, theTuple);
 
         return theTuple;
     }
 
+    //! Decodes the current and all following rows into structs described by a RowSchema.
+    //! Column types are validated once, returns false and logs the mismatch if they don't fit the schema.
+    template<typename Schema>
+    bool FetchRows(std::vector<typename Schema::Row>& rows)
+    {
+        if (!Schema::Validate(_data->FieldMetadata, _fieldCount, true))
+            return false;
+
+        rows.reserve(rows.size() + (_streamed ? 0 : _rowCount - _rowPosition));
+        do
+        {
+            Schema::Decode(_currRow.get(), rows.emplace_back());
+        } while (NextRow());
+
+        return true;
+    }
+
+    //! Returns std::nullopt if the column types don't fit the schema
+    template<typename Schema>
+    std::optional<std::vector<typename Schema::Row>> FetchRows()
+    {
+        std::vector<typename Schema::Row> rows;
+        if (!FetchRows<Schema>(rows))
+            return std::nullopt;
+
+        return rows;
+    }
+
+    //! Whole column of a buffered result, not available for streamed results
+    template<typename T>
+    [[nodiscard]] ResultColumn<T> GetColumn(uint32 index) const
+    {
+        return ResultColumn<T>(GetColumnStorage(index, std::is_same_v<T, std::string_view> ? 0 : uint32(sizeof(T))), _rowCount);
+    }
+
     auto begin()        { return ResultIterator<PreparedResultSet>(this); }
     static auto end()   { return ResultIterator<PreparedResultSet>(nullptr); }
 
 protected:
-    std::vector<QueryResultFieldMetadata> _fieldMetadata;
-    std::vector<Field> _rows;
+    std::shared_ptr<PreparedResultData const> _data;
+    std::unique_ptr<Field[]> _currRow; ///< Points to the values of the current row
     uint64 _rowCount;
     uint64 _rowPosition{};
     uint32 _fieldCount;
 
 private:
-    MySQLBind* _rBind{ nullptr };
     MySQLStmt* _stmt;
     MySQLResult* _metadataResult;    ///< Field metadata, returned by mysql_stmt_result_metadata
 
+    // Streamed results only
+    MySQLBind* _rBind{ nullptr };
+    std::unique_ptr<char[]> _streamArena; ///< Binds and the buffer of the current row
+    MySQLConnection* _streamConnection{ nullptr };
+    bool _streamed{};
+    std::vector<std::vector<char>> _streamOverflow; ///< Values which did not fit the streamed row buffer
+
     void CleanUp();
-    bool _NextRow();
+    void InitFields();
+    void SetCurrentRow();
+    bool NextStreamedRow();
 
+    [[nodiscard]] PreparedResultColumn const* GetColumnStorage(uint32 index, uint32 width) const;
     void AssertRows(std::size_t sizeRows) const;
 
     PreparedResultSet(PreparedResultSet const& right) = delete;
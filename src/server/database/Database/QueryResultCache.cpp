@@ -0,0 +1,230 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "QueryResultCache.h"
+#include "Errors.h"
+#include "Log.h"
+#include "PreparedStatement.h"
+#include "QueryResult.h"
+
+namespace
+{
+    inline void AppendIndexKey(std::string& key, uint32 index)
+    {
+        key.append(reinterpret_cast<char const*>(&index), sizeof(index));
+    }
+
+    inline std::size_t GetEntrySize(std::string const& key, PreparedResultData const& data)
+    {
+        return key.size() + data.ArenaSize;
+    }
+}
+
+QueryResultCache::~QueryResultCache() = default;
+
+void QueryResultCache::EnableStatement(uint32 index, Milliseconds ttl, uint8 partitionParams /*= 0*/)
+{
+    ASSERT(ttl > 0ms, "> Result cache TTL of statement {} must be positive", index);
+    _statements[index] = { ttl, partitionParams };
+}
+
+void QueryResultCache::AddInvalidation(uint32 writeIndex, uint32 readIndex, std::vector<uint8> writeParams /*= {}*/)
+{
+    auto const& itr = _statements.find(readIndex);
+    ASSERT(itr != _statements.end(), "> Result cache is not enabled for statement {}", readIndex);
+    ASSERT(writeParams.empty() || writeParams.size() == itr->second.PartitionParams,
+        "> Invalidation of statement {} by {} must use {} parameters", readIndex, writeIndex, itr->second.PartitionParams);
+
+    _writeDependencies.emplace(writeIndex, InvalidationInfo{ readIndex, std::move(writeParams) });
+}
+
+void QueryResultCache::SetMaxSize(std::size_t maxSize)
+{
+    std::lock_guard guard(_mutex);
+    _maxSize = maxSize;
+}
+
+bool QueryResultCache::IsEnabled(uint32 index) const
+{
+    return _statements.find(index) != _statements.end();
+}
+
+std::string QueryResultCache::MakeKey(PreparedStatementBase const& stmt) const
+{
+    std::string key;
+    AppendIndexKey(key, stmt.GetIndex());
+
+    for (uint8 i = 0; i < stmt.GetParameterCount(); ++i)
+        stmt.AppendParameterKey(i, key);
+
+    return key;
+}
+
+QueryResultCache::ResultData QueryResultCache::Get(std::string const& key)
+{
+    std::lock_guard guard(_mutex);
+
+    auto const& itr = _entries.find(key);
+    if (itr == _entries.end())
+    {
+        ++_misses;
+        return nullptr;
+    }
+
+    if (itr->second.ExpireTime <= std::chrono::steady_clock::now())
+    {
+        Erase(itr);
+        ++_misses;
+        return nullptr;
+    }
+
+    _lru.splice(_lru.begin(), _lru, itr->second.LruItr);
+    ++_hits;
+    return itr->second.Data;
+}
+
+void QueryResultCache::Store(std::string key, PreparedResultSet const* result, uint64 generation)
+{
+    // Errors are not cached
+    if (!result || result->IsStreamed() || !result->GetData() || result->GetData()->Truncated)
+        return;
+
+    uint32 index{};
+    ASSERT(key.size() >= sizeof(index));
+    memcpy(&index, key.data(), sizeof(index));
+
+    auto const& config = _statements.find(index);
+    if (config == _statements.end())
+        return;
+
+    std::lock_guard guard(_mutex);
+
+    if (generation != GetGeneration())
+        return;
+
+    auto const& data = result->GetData();
+    std::size_t size = GetEntrySize(key, *data);
+    if (size > _maxSize)
+        return;
+
+    if (auto const& itr = _entries.find(key); itr != _entries.end())
+        Erase(itr);
+
+    auto [itr, inserted] = _entries.emplace(std::move(key), Entry{ data, std::chrono::steady_clock::now() + config->second.TTL, size, {} });
+    _lru.emplace_front(itr->first);
+    itr->second.LruItr = _lru.begin();
+    _size += size;
+
+    while (_size > _maxSize && !_lru.empty())
+    {
+        Erase(_entries.find(_lru.back()));
+        ++_evictions;
+    }
+}
+
+void QueryResultCache::Invalidate(PreparedStatementBase const& stmt)
+{
+    auto range = _writeDependencies.equal_range(stmt.GetIndex());
+    if (range.first == range.second)
+        return;
+
+    std::lock_guard guard(_mutex);
+
+    // Stores of queries started before the invalidation are dropped
+    _generation.fetch_add(1, std::memory_order_release);
+
+    std::string prefix;
+
+    for (auto itr = range.first; itr != range.second; ++itr)
+    {
+        auto const& [readIndex, writeParams] = itr->second;
+
+        prefix.clear();
+        AppendIndexKey(prefix, readIndex);
+
+        for (uint8 param : writeParams)
+            stmt.AppendParameterKey(param, prefix);
+
+        ErasePrefix(prefix);
+    }
+}
+
+void QueryResultCache::InvalidateStatement(uint32 index)
+{
+    std::lock_guard guard(_mutex);
+    _generation.fetch_add(1, std::memory_order_release);
+
+    std::string prefix;
+    AppendIndexKey(prefix, index);
+    ErasePrefix(prefix);
+}
+
+void QueryResultCache::Clear()
+{
+    std::lock_guard guard(_mutex);
+    _generation.fetch_add(1, std::memory_order_release);
+
+    _invalidationCount += _entries.size();
+    _entries.clear();
+    _lru.clear();
+    _size = 0;
+}
+
+void QueryResultCache::PurgeExpired()
+{
+    std::lock_guard guard(_mutex);
+
+    auto const now = std::chrono::steady_clock::now();
+
+    for (auto itr = _entries.begin(); itr != _entries.end();)
+    {
+        auto next = std::next(itr);
+
+        if (itr->second.ExpireTime <= now)
+            Erase(itr);
+
+        itr = next;
+    }
+}
+
+QueryResultCacheStats QueryResultCache::GetStats() const
+{
+    std::lock_guard guard(_mutex);
+    return { _hits, _misses, _evictions, _invalidationCount, _entries.size(), _size, _maxSize };
+}
+
+void QueryResultCache::ErasePrefix(std::string_view prefix)
+{
+    // Keys with the same prefix are stored one after another
+    for (auto itr = _entries.lower_bound(prefix); itr != _entries.end() && itr->first.starts_with(prefix);)
+    {
+        auto next = std::next(itr);
+        Erase(itr);
+        ++_invalidationCount;
+        itr = next;
+    }
+}
+
+void QueryResultCache::Erase(EntryMap::iterator itr)
+{
+    _size -= itr->second.Size;
+    _lru.erase(itr->second.LruItr);
+    _entries.erase(itr);
+}
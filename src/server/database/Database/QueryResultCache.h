@@ -0,0 +1,145 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _QUERY_RESULT_CACHE_H
+#define _QUERY_RESULT_CACHE_H
+
+#include "DatabaseEnvFwd.h"
+#include "Duration.h"
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct PreparedResultData;
+
+//! Default memory limit of cached results of one pool
+constexpr std::size_t DEFAULT_RESULT_CACHE_SIZE = 16 * 1024 * 1024;
+
+struct QueryResultCacheStats
+{
+    uint64 Hits{};
+    uint64 Misses{};
+    uint64 Evictions{};
+    uint64 Invalidations{};
+    std::size_t Entries{};
+    std::size_t Size{};
+    std::size_t MaxSize{};
+};
+
+/**
+    Cache of prepared query results, keyed by statement index and parameter values.
+
+    Entries are immutable snapshots of buffered rows (PreparedResultData) shared by all result sets built from them,
+    evicted by TTL and by LRU order when the memory limit is reached.
+
+    First partitionParams parameters of a cached statement form its partition (e.g. guild id).
+    Successful execution of a declared write statement drops cached results of the partition given by its own parameters:
+
+    EnableStatement(DISCORD_SEL_NICKNAMES, 5min, 1);                   // WHERE `discord_guild_id` = ?
+    AddInvalidation(DISCORD_INS_NICKNAME, DISCORD_SEL_NICKNAMES, { 0 }); // VALUES (discord_guild_id, ...)
+
+    Parameters used as partition must have the same type in both statements.
+    Configuration is not thread safe, it must be done before the pool is used (DoPrepareStatements).
+*/
+class WH_DATABASE_API QueryResultCache
+{
+public:
+    using ResultData = std::shared_ptr<PreparedResultData const>;
+
+    QueryResultCache() = default;
+    ~QueryResultCache();
+
+    void EnableStatement(uint32 index, Milliseconds ttl, uint8 partitionParams = 0);
+
+    //! Empty writeParams drops all cached results of readIndex
+    void AddInvalidation(uint32 writeIndex, uint32 readIndex, std::vector<uint8> writeParams = {});
+
+    void SetMaxSize(std::size_t maxSize);
+
+    [[nodiscard]] inline bool IsEnabled() const { return !_statements.empty(); }
+    [[nodiscard]] bool IsEnabled(uint32 index) const;
+    [[nodiscard]] std::string MakeKey(PreparedStatementBase const& stmt) const;
+
+    //! Returns nullptr on miss
+    ResultData Get(std::string const& key);
+
+    //! Taken before the query is executed and passed to Store
+    [[nodiscard]] inline uint64 GetGeneration() const { return _generation.load(std::memory_order_acquire); }
+
+    //! Result is dropped if it's incomplete or if any invalidation happened after generation was taken, it could be stale already
+    void Store(std::string key, PreparedResultSet const* result, uint64 generation);
+
+    //! Called after a write statement was executed
+    void Invalidate(PreparedStatementBase const& stmt);
+    void InvalidateStatement(uint32 index);
+    void Clear();
+
+    void PurgeExpired();
+
+    [[nodiscard]] QueryResultCacheStats GetStats() const;
+
+private:
+    struct StatementConfig
+    {
+        Milliseconds TTL{};
+        uint8 PartitionParams{};
+    };
+
+    struct InvalidationInfo
+    {
+        uint32 ReadIndex{};
+        std::vector<uint8> WriteParams;
+    };
+
+    using LruList = std::list<std::string_view>; ///< Views of the keys of _entries, most recently used first
+
+    struct Entry
+    {
+        ResultData Data;
+        TimePoint ExpireTime;
+        std::size_t Size{};
+        LruList::iterator LruItr;
+    };
+
+    using EntryMap = std::map<std::string, Entry, std::less<>>;
+
+    void ErasePrefix(std::string_view prefix);
+    void Erase(EntryMap::iterator itr);
+
+    std::unordered_map<uint32, StatementConfig> _statements;
+    std::unordered_multimap<uint32, InvalidationInfo> _writeDependencies;
+
+    mutable std::mutex _mutex;
+    EntryMap _entries;
+    LruList _lru;
+    std::size_t _size{};
+    std::size_t _maxSize{ DEFAULT_RESULT_CACHE_SIZE };
+    std::atomic<uint64> _generation{};
+
+    uint64 _hits{};
+    uint64 _misses{};
+    uint64 _evictions{};
+    uint64 _invalidationCount{};
+
+    QueryResultCache(QueryResultCache const& right) = delete;
+    QueryResultCache& operator=(QueryResultCache const& right) = delete;
+};
+
+#endif
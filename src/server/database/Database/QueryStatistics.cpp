@@ -0,0 +1,206 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "QueryStatistics.h"
+#include "Tokenize.h"
+#include "Util.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace
+{
+    // Table following INTO, UPDATE or FROM, empty if the statement has none
+    std::string_view GetWrittenTable(std::string_view sql)
+    {
+        bool tableFollows = false;
+
+        for (std::string_view word : Warhead::Tokenize(sql, ' ', false))
+        {
+            if (!tableFollows)
+            {
+                tableFollows = StringEqualI(word, "INTO") || StringEqualI(word, "UPDATE") || StringEqualI(word, "FROM");
+                continue;
+            }
+
+            word = word.substr(0, word.find_first_of("(,;"));
+
+            while (!word.empty() && word.front() == '`')
+                word.remove_prefix(1);
+
+            while (!word.empty() && word.back() == '`')
+                word.remove_suffix(1);
+
+            return word;
+        }
+
+        return {};
+    }
+}
+
+void LatencyHistogram::Add(Microseconds value)
+{
+    uint64 const time = uint64(std::max<int64>(value.count(), 0));
+
+    _buckets[GetBucket(time)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+
+    uint64 max = _max.load(std::memory_order_relaxed);
+    while (time > max && !_max.compare_exchange_weak(max, time, std::memory_order_relaxed)) { }
+}
+
+Microseconds LatencyHistogram::GetPercentile(double percentile) const
+{
+    uint64 const count = GetCount();
+    if (!count)
+        return 0us;
+
+    // Rank of the value, 1 based
+    auto const rank = std::max<uint64>(uint64(std::ceil(std::clamp(percentile, 0.0, 1.0) * double(count))), 1);
+    uint64 seen{};
+
+    for (uint32 bucket{}; bucket < BUCKET_COUNT; ++bucket)
+    {
+        seen += _buckets[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return Microseconds(std::min(GetBucketUpperBound(bucket), _max.load(std::memory_order_relaxed)));
+    }
+
+    return GetMax();
+}
+
+/*static*/ uint32 LatencyHistogram::GetBucket(uint64 value)
+{
+    if (value < LINEAR_BUCKETS)
+        return uint32(value);
+
+    uint32 const exponent = std::min<uint32>(std::bit_width(value) - 1, MAX_EXPONENT);
+    if (exponent == MAX_EXPONENT)
+        return BUCKET_COUNT - 1;
+
+    // Top bits after the leading one select the sub bucket
+    uint32 const subBucket = uint32(value >> (exponent - SUB_BUCKET_BITS)) & ((1 << SUB_BUCKET_BITS) - 1);
+    return LINEAR_BUCKETS + (exponent - 4) * (1 << SUB_BUCKET_BITS) + subBucket;
+}
+
+/*static*/ uint64 LatencyHistogram::GetBucketUpperBound(uint32 bucket)
+{
+    if (bucket < LINEAR_BUCKETS)
+        return bucket;
+
+    // Values out of range, only bounded by the max
+    if (bucket == BUCKET_COUNT - 1)
+        return std::numeric_limits<uint64>::max();
+
+    uint32 const exponent = 4 + (bucket - LINEAR_BUCKETS) / (1 << SUB_BUCKET_BITS);
+    uint32 const subBucket = (bucket - LINEAR_BUCKETS) % (1 << SUB_BUCKET_BITS);
+    uint32 const shift = exponent - SUB_BUCKET_BITS;
+
+    return ((uint64((1 << SUB_BUCKET_BITS) + subBucket + 1)) << shift) - 1;
+}
+
+void QueryStatistics::SetStatementCount(uint32 count)
+{
+    if (count == _statementCount)
+        return;
+
+    _statements = std::make_unique<Entry[]>(count);
+    _statementCount = count;
+}
+
+void QueryStatistics::RecordQuery(uint32 index, Microseconds time, bool error)
+{
+    Entry* entry = GetEntry(index);
+    if (!entry)
+        return;
+
+    entry->Calls.fetch_add(1, std::memory_order_relaxed);
+
+    if (error)
+        entry->Errors.fetch_add(1, std::memory_order_relaxed);
+
+    entry->Latency.Add(time);
+}
+
+void QueryStatistics::RecordRows(uint32 index, uint64 rows)
+{
+    if (Entry* entry = GetEntry(index))
+        entry->Rows.fetch_add(rows, std::memory_order_relaxed);
+}
+
+bool QueryStatistics::GetInfo(uint32 index, QueryStatisticsInfo& info) const
+{
+    Entry const* entry = GetEntry(index);
+    if (!entry)
+        return false;
+
+    info.Calls = entry->Calls.load(std::memory_order_relaxed);
+    if (!info.Calls)
+        return false;
+
+    info.Errors = entry->Errors.load(std::memory_order_relaxed);
+    info.Rows = entry->Rows.load(std::memory_order_relaxed);
+    info.P50 = entry->Latency.GetPercentile(0.5);
+    info.P99 = entry->Latency.GetPercentile(0.99);
+    info.Max = entry->Latency.GetMax();
+    return true;
+}
+
+void QueryStatistics::GetQueueWaitInfo(QueryStatisticsInfo& info) const
+{
+    info.Calls = _queueWait.GetCount();
+    info.P50 = _queueWait.GetPercentile(0.5);
+    info.P99 = _queueWait.GetPercentile(0.99);
+    info.Max = _queueWait.GetMax();
+}
+
+void QueryStatistics::RecordDeadlock(std::string_view sql)
+{
+    std::string_view table = GetWrittenTable(sql);
+
+    std::lock_guard<std::mutex> lock(_deadlockLock);
+    ++_deadlocks[std::string{ table.empty() ? "<unknown>" : table }];
+}
+
+std::vector<std::pair<std::string, uint64>> QueryStatistics::GetDeadlockInfo() const
+{
+    std::vector<std::pair<std::string, uint64>> tables;
+
+    {
+        std::lock_guard<std::mutex> lock(_deadlockLock);
+        tables.assign(_deadlocks.begin(), _deadlocks.end());
+    }
+
+    std::sort(tables.begin(), tables.end(), [](auto const& left, auto const& right) { return left.second > right.second; });
+    return tables;
+}
+
+QueryStatistics::Entry* QueryStatistics::GetEntry(uint32 index)
+{
+    if (index == STRING_QUERY_INDEX)
+        return &_stringQueries;
+
+    return index < _statementCount ? &_statements[index] : nullptr;
+}
+
+QueryStatistics::Entry const* QueryStatistics::GetEntry(uint32 index) const
+{
+    return const_cast<QueryStatistics*>(this)->GetEntry(index);
+}
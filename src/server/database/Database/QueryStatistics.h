@@ -0,0 +1,160 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _QUERY_STATISTICS_H
+#define _QUERY_STATISTICS_H
+
+#include "Define.h"
+#include "Duration.h"
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//! Default time after which a query is logged as slow
+constexpr Milliseconds DEFAULT_SLOW_QUERY_THRESHOLD = 1s;
+
+//! Log-linear histogram of latencies in microseconds, 8 buckets per power of two (error below 12.5%). Lock free.
+class WH_DATABASE_API LatencyHistogram
+{
+public:
+    LatencyHistogram() = default;
+
+    void Add(Microseconds value);
+
+    //! Upper bound of the bucket holding the percentile, percentile in [0, 1]
+    [[nodiscard]] Microseconds GetPercentile(double percentile) const;
+    [[nodiscard]] inline Microseconds GetMax() const { return Microseconds(_max.load(std::memory_order_relaxed)); }
+    [[nodiscard]] inline uint64 GetCount() const { return _count.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32 LINEAR_BUCKETS = 16;
+    static constexpr uint32 SUB_BUCKET_BITS = 3;
+    static constexpr uint32 MAX_EXPONENT = 35; // ~9.5 hours, longer values are counted in the last bucket
+    static constexpr uint32 BUCKET_COUNT = LINEAR_BUCKETS + (MAX_EXPONENT - 4) * (1 << SUB_BUCKET_BITS) + 1;
+
+    static uint32 GetBucket(uint64 value);
+    static uint64 GetBucketUpperBound(uint32 bucket);
+
+    std::array<std::atomic<uint64>, BUCKET_COUNT> _buckets{};
+    std::atomic<uint64> _count{};
+    std::atomic<uint64> _max{};
+
+    LatencyHistogram(LatencyHistogram const& right) = delete;
+    LatencyHistogram& operator=(LatencyHistogram const& right) = delete;
+};
+
+struct QueryStatisticsInfo
+{
+    uint64 Calls{};
+    uint64 Errors{};
+    uint64 Rows{};
+    Microseconds P50{};
+    Microseconds P99{};
+    Microseconds Max{};
+};
+
+/**
+    Always on statistics of the queries executed by the connections of one pool.
+
+    Calls, errors, returned rows and execution latency are kept per prepared statement index,
+    string queries share one entry. Time spent by async operations in the queue is measured separately.
+    Counters are relaxed atomics, recording doesn't lock.
+*/
+class WH_DATABASE_API QueryStatistics
+{
+public:
+    static constexpr uint32 STRING_QUERY_INDEX = std::numeric_limits<uint32>::max();
+
+    QueryStatistics() = default;
+    ~QueryStatistics() = default;
+
+    //! Not thread safe, called once the statements are known and before they are executed
+    void SetStatementCount(uint32 count);
+    inline void SetSlowQueryThreshold(Milliseconds threshold) { _slowQueryThreshold = threshold; }
+
+    //! Slow queries are logged by the connection, it has the statement text and parameters
+    [[nodiscard]] inline bool IsSlowQuery(Microseconds time) const { return _slowQueryThreshold > 0ms && time >= _slowQueryThreshold; }
+
+    void RecordQuery(uint32 index, Microseconds time, bool error);
+    void RecordRows(uint32 index, uint64 rows);
+    inline void RecordQueueWait(Microseconds time) { _queueWait.Add(time); }
+    inline void RecordDropped() { _dropped.fetch_add(1, std::memory_order_relaxed); }
+
+    //! Deadlocks are counted by the table the failed statement writes to
+    void RecordDeadlock(std::string_view sql);
+    inline void RecordDeadlockFailure() { _deadlockFailures.fetch_add(1, std::memory_order_relaxed); }
+
+    inline void RecordGroupCommit(std::size_t writes)
+    {
+        _groupCommits.fetch_add(1, std::memory_order_relaxed);
+        _groupedWrites.fetch_add(writes, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] inline uint32 GetStatementCount() const { return _statementCount; }
+
+    //! Returns false if the statement was never executed
+    bool GetInfo(uint32 index, QueryStatisticsInfo& info) const;
+    void GetQueueWaitInfo(QueryStatisticsInfo& info) const;
+
+    //! Async operations not executed because they were cancelled or expired
+    [[nodiscard]] inline uint64 GetDroppedCount() const { return _dropped.load(std::memory_order_relaxed); }
+
+    //! Deadlock count per table, sorted by count
+    [[nodiscard]] std::vector<std::pair<std::string, uint64>> GetDeadlockInfo() const;
+
+    //! Transactions not executed because they were still deadlocked after all retries
+    [[nodiscard]] inline uint64 GetDeadlockFailureCount() const { return _deadlockFailures.load(std::memory_order_relaxed); }
+
+    //! Transactions committed by group commit and the writes they contained
+    [[nodiscard]] inline uint64 GetGroupCommitCount() const { return _groupCommits.load(std::memory_order_relaxed); }
+    [[nodiscard]] inline uint64 GetGroupedWriteCount() const { return _groupedWrites.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry
+    {
+        std::atomic<uint64> Calls{};
+        std::atomic<uint64> Errors{};
+        std::atomic<uint64> Rows{};
+        LatencyHistogram Latency;
+    };
+
+    Entry* GetEntry(uint32 index);
+    [[nodiscard]] Entry const* GetEntry(uint32 index) const;
+
+    std::unique_ptr<Entry[]> _statements;
+    uint32 _statementCount{};
+    Entry _stringQueries;
+    LatencyHistogram _queueWait;
+    std::atomic<uint64> _dropped{};
+    std::atomic<uint64> _deadlockFailures{};
+    std::atomic<uint64> _groupCommits{};
+    std::atomic<uint64> _groupedWrites{};
+    Milliseconds _slowQueryThreshold{ DEFAULT_SLOW_QUERY_THRESHOLD };
+
+    mutable std::mutex _deadlockLock;
+    std::unordered_map<std::string, uint64> _deadlocks; ///< Rare, counted under the lock
+
+    QueryStatistics(QueryStatistics const& right) = delete;
+    QueryStatistics& operator=(QueryStatistics const& right) = delete;
+};
+
+#endif
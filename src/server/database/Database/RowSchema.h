@@ -0,0 +1,153 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ROW_SCHEMA_H
+#define _ROW_SCHEMA_H
+
+#include "Field.h"
+#include "Util.h"
+#include <tuple>
+
+namespace Warhead::Impl
+{
+    template<typename T>
+    struct MemberPointerTraits;
+
+    template<typename R, typename T>
+    struct MemberPointerTraits<T R::*>
+    {
+        using Row = R;
+        using Type = T;
+    };
+
+    template<typename T>
+    constexpr bool IsIntegerField(DatabaseFieldTypes type, bool binaryProtocol)
+    {
+        if (!binaryProtocol)
+            return type >= DatabaseFieldTypes::Int8 && type <= DatabaseFieldTypes::Int64;
+
+        switch (sizeof(T))
+        {
+            case 1: return type == DatabaseFieldTypes::Int8;
+            case 2: return type == DatabaseFieldTypes::Int16;
+            case 4: return type == DatabaseFieldTypes::Int32;
+            case 8: return type == DatabaseFieldTypes::Int64;
+            default: return false;
+        }
+    }
+
+    //! Text protocol values are converted from strings, so only the kind of the column matters.
+    //! Binary protocol values are copied as is, so the width must match.
+    template<typename T>
+    constexpr bool IsCompatibleFieldType(DatabaseFieldTypes type, bool binaryProtocol)
+    {
+        if (type == DatabaseFieldTypes::Null)
+            return true;
+
+        if constexpr (std::is_integral_v<T>)
+            return IsIntegerField<T>(type, binaryProtocol);
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            if (type == DatabaseFieldTypes::Decimal)
+                return true;
+
+            if (binaryProtocol)
+                return type == (std::is_same_v<T, float> ? DatabaseFieldTypes::Float : DatabaseFieldTypes::Double);
+
+            return type >= DatabaseFieldTypes::Int8 && type <= DatabaseFieldTypes::Double;
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+            return !binaryProtocol || type == DatabaseFieldTypes::Binary || type == DatabaseFieldTypes::Decimal;
+        else if constexpr (std::is_same_v<T, Binary>)
+            return type == DatabaseFieldTypes::Binary;
+        else
+            return false;
+    }
+
+    WH_DATABASE_API bool LogRowSchemaSizeMismatch(uint32 columnCount, uint32 fieldCount);
+    WH_DATABASE_API bool LogRowSchemaTypeMismatch(QueryResultFieldMetadata const& metadata, std::string_view typeName);
+}
+
+/**
+    Compile time mapping of the columns of a result to the members of a struct, in select order.
+
+    struct NicknameRow { std::string Nickname; int32 Ilvl{}; };
+    using NicknameSchema = RowSchema<&NicknameRow::Nickname, &NicknameRow::Ilvl>;
+
+    if (auto rows = result->FetchRows<NicknameSchema>())
+        for (auto const& row : *rows)
+
+    The column types are validated once per result (see ResultSet::FetchRows), rows are decoded without type checks.
+    Decoded rows outlive the row buffers of the result, so members can't be views like std::string_view.
+*/
+template<auto FirstMember, auto... Members>
+struct RowSchema
+{
+    using Row = typename Warhead::Impl::MemberPointerTraits<decltype(FirstMember)>::Row;
+
+    static_assert((std::is_same_v<Row, typename Warhead::Impl::MemberPointerTraits<decltype(Members)>::Row> && ...),
+        "All members of a row schema must belong to the same struct");
+
+    static constexpr uint32 ColumnCount = 1 + sizeof...(Members);
+
+    static bool Validate(QueryResultFieldMetadata const* metadata, uint32 fieldCount, bool binaryProtocol)
+    {
+        if (fieldCount != ColumnCount)
+            return Warhead::Impl::LogRowSchemaSizeMismatch(ColumnCount, fieldCount);
+
+        return ValidateColumns(metadata, binaryProtocol, std::make_index_sequence<ColumnCount>{});
+    }
+
+    static void Decode(Field const* fields, Row& row)
+    {
+        static_assert(!HasViewColumns(std::make_index_sequence<ColumnCount>{}),
+            "Rows are owning, the row buffer is freed by NextRow. Use std::string instead of std::string_view");
+
+        DecodeColumns(fields, row, std::make_index_sequence<ColumnCount>{});
+    }
+
+private:
+    static constexpr auto MemberList = std::make_tuple(FirstMember, Members...);
+
+    template<std::size_t I>
+    using ColumnType = typename Warhead::Impl::MemberPointerTraits<std::tuple_element_t<I, std::remove_cv_t<decltype(MemberList)>>>::Type;
+
+    template<std::size_t... I>
+    static constexpr bool HasViewColumns(std::index_sequence<I...>)
+    {
+        return (std::is_same_v<ColumnType<I>, std::string_view> || ...);
+    }
+
+    template<std::size_t... I>
+    static bool ValidateColumns(QueryResultFieldMetadata const* metadata, bool binaryProtocol, std::index_sequence<I...>)
+    {
+        bool valid = true;
+
+        ((valid &= Warhead::Impl::IsCompatibleFieldType<ColumnType<I>>(metadata[I].Type, binaryProtocol) ||
+            Warhead::Impl::LogRowSchemaTypeMismatch(metadata[I], GetTypeName<ColumnType<I>>())), ...);
+
+        return valid;
+    }
+
+    template<std::size_t... I>
+    static void DecodeColumns(Field const* fields, Row& row, std::index_sequence<I...>)
+    {
+        ((row.*std::get<I>(MemberList) = fields[I].template GetUnchecked<ColumnType<I>>()), ...);
+    }
+};
+
+#endif
@@ -19,17 +19,26 @@
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 
 #include "Transaction.h"
+#include "DatabaseCircuitBreaker.h"
 #include "Errors.h"
 #include "Log.h"
 #include "MySQLConnection.h"
 #include "PreparedStatement.h"
+#include "QueryStatistics.h"
 #include "Timer.h"
+#include <errmsg.h>
 #include <mysqld_error.h>
-#include <sstream>
 #include <thread>
 
-std::mutex TransactionTask::_deadlockLock;
-constexpr Milliseconds DEADLOCK_MAX_RETRY_TIME_MS = 1min;
+std::atomic<uint32> TransactionTask::_maxDeadlockRetries{ DEFAULT_DEADLOCK_MAX_RETRIES };
+
+namespace
+{
+    bool IsConnectionLost(int32 errorCode)
+    {
+        return errorCode == CR_SERVER_GONE_ERROR || errorCode == CR_SERVER_LOST || errorCode == CR_SERVER_LOST_EXTENDED;
+    }
+}
 
 //- Append a raw ad-hoc query to the transaction
 void Transaction::Append(std::string_view sql)
@@ -95,39 +104,23 @@ void Transaction::Cleanup()
 
 void TransactionTask::ExecuteQuery()
 {
-    int errorCode = TryExecute();
-    if (!errorCode)
+    auto errorCode = ExecuteWithDeadlockRetries();
+    if (!errorCode || !*errorCode)
         return;
 
-    if (errorCode == ER_LOCK_DEADLOCK)
-    {
-        std::ostringstream threadIdStream;
-        threadIdStream << std::this_thread::get_id();
-        std::string threadId = threadIdStream.str();
-
-        {
-            // Make sure only 1 async thread retries a transaction, so they don't keep deadlocking each other
-            std::lock_guard<std::mutex> lock(_deadlockLock);
-
-            for (Milliseconds loopDuration = 0s, startMSTime = GetTimeMS(); loopDuration <= DEADLOCK_MAX_RETRY_TIME_MS; loopDuration = GetMSTimeDiffToNow(startMSTime))
-            {
-                if (!TryExecute())
-                    return;
-
-                LOG_WARN("db.query", "Deadlocked SQL Transaction, retrying. Loop timer: {} ms, Thread Id: {}", loopDuration.count(), threadId);
-            }
-        }
-
-        LOG_ERROR("db.query", "Fatal deadlocked SQL Transaction, it will not be retried anymore. Thread Id: {}", threadId);
-    }
-
     // Clean up now.
     CleanupOnFailure();
 }
 
 int32 TransactionTask::TryExecute()
 {
-    return _connection->ExecuteTransaction(_trans);
+    int32 errorCode = _connection->ExecuteTransaction(_trans);
+
+    // Server rolled back the statements of the lost session, the whole transaction is executed again once
+    if (IsConnectionLost(errorCode) && _connection->WaitForReconnect(_connection->GetParkDeadline(_enqueueTime)))
+        errorCode = _connection->ExecuteTransaction(_trans);
+
+    return errorCode;
 }
 
 void TransactionTask::CleanupOnFailure()
@@ -135,38 +128,52 @@ void TransactionTask::CleanupOnFailure()
     _trans->Cleanup();
 }
 
-void TransactionWithResultTask::ExecuteQuery()
+std::optional<int32> TransactionTask::ExecuteWithDeadlockRetries()
 {
-    int errorCode = TryExecute();
-    if (!errorCode)
-    {
-        _result.set_value(true);
-        return;
-    }
+    int32 errorCode = TryExecute();
+    uint32 const maxRetries = GetMaxDeadlockRetries();
 
-    if (errorCode == ER_LOCK_DEADLOCK)
+    while (errorCode == ER_LOCK_DEADLOCK)
     {
-        std::ostringstream threadIdStream;
-        threadIdStream << std::this_thread::get_id();
-        std::string threadId = threadIdStream.str();
-
+        if (_deadlockRetries >= maxRetries)
         {
-            // Make sure only 1 async thread retries a transaction, so they don't keep deadlocking each other
-            std::lock_guard<std::mutex> lock(_deadlockLock);
+            LOG_ERROR("db.query", "Fatal deadlocked SQL Transaction, it will not be retried anymore after {} retries", _deadlockRetries);
 
-            for (Milliseconds loopDuration = 0s, startMSTime = GetTimeMS(); loopDuration <= DEADLOCK_MAX_RETRY_TIME_MS; loopDuration = GetMSTimeDiffToNow(startMSTime))
-            {
-                if (!TryExecute())
-                {
-                    _result.set_value(true);
-                    return;
-                }
+            if (auto statistics = _connection->GetStatistics())
+                statistics->RecordDeadlockFailure();
 
-                LOG_WARN("db.query", "Deadlocked SQL Transaction, retrying. Loop timer: {} ms, Thread Id: {}", loopDuration.count(), threadId);
-            }
+            break;
+        }
+
+        // Transactions deadlocked with each other are spread by the jitter
+        Milliseconds const delay = GetBackoffDelay(_deadlockRetries++, DEADLOCK_RETRY_MIN_DELAY, DEADLOCK_RETRY_MAX_DELAY);
+        LOG_WARN("db.query", "Deadlocked SQL Transaction, retry {}/{} in {}", _deadlockRetries, maxRetries, Warhead::Time::ToTimeString(delay));
+
+        // Worker executes other operations meanwhile
+        if (!_trans->IsOrderDependent())
+        {
+            ScheduleRetry(std::chrono::steady_clock::now() + delay);
+            return std::nullopt;
         }
 
-        LOG_ERROR("db.query", "Fatal deadlocked SQL Transaction, it will not be retried anymore. Thread Id: {}", threadId);
+        // Later writes of this worker (e.g. a DELETE of the inserted rows) don't overtake the retry
+        std::this_thread::sleep_for(delay);
+        errorCode = TryExecute();
+    }
+
+    return errorCode;
+}
+
+void TransactionWithResultTask::ExecuteQuery()
+{
+    auto errorCode = ExecuteWithDeadlockRetries();
+    if (!errorCode)
+        return;
+
+    if (!*errorCode)
+    {
+        _result.set_value(true);
+        return;
     }
 
     // Clean up now.
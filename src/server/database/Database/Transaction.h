@@ -19,12 +19,17 @@
 #define _TRANSACTION_H
 
 #include "DatabaseAsyncOperation.h"
-#include "StringFormat.h"
+#include "QueryBuilder.h"
+#include <atomic>
 #include <functional>
-#include <mutex>
 #include <variant>
 #include <vector>
 
+//! Deadlocked transactions are retried after a jittered delay, doubled after every retry
+constexpr Milliseconds DEADLOCK_RETRY_MIN_DELAY = 10ms;
+constexpr Milliseconds DEADLOCK_RETRY_MAX_DELAY = 1s;
+constexpr uint32 DEFAULT_DEADLOCK_MAX_RETRIES = 10;
+
 //- Type specifier of our element data
 enum SQLElementDataType
 {
@@ -50,7 +55,7 @@ public:
     template<typename... Args>
     void Append(std::string_view sql, Args&&... args)
     {
-        Append(Warhead::StringFormat(sql, std::forward<Args>(args)...));
+        Append(QueryBuilder::Format(sql, std::forward<Args>(args)...));
     }
 
     void Append(PreparedStatement stmt);
@@ -58,11 +63,17 @@ public:
     [[nodiscard]] std::size_t GetSize() const { return _queries.size(); }
     auto GetQueries() { return &_queries; }
 
+    //! Deadlock retry of an async transaction waits in the queue by default and can run after writes queued later.
+    //! An order dependent transaction blocks its worker during the backoff instead. Writes of other workers can still overtake it.
+    inline void SetOrderDependent() { _orderDependent = true; }
+    [[nodiscard]] inline bool IsOrderDependent() const { return _orderDependent; }
+
     void Cleanup();
 
 private:
     std::vector<SQLElementData> _queries;
     bool _cleanedUp{false};
+    bool _orderDependent{};
 };
 
 class WH_DATABASE_API TransactionTask : public AsyncOperation
@@ -73,13 +84,25 @@ public:
 
     ~TransactionTask() override = default;
 
+    //! Retries of a deadlocked transaction (Database.Deadlock.MaxRetries), shared by all pools
+    static inline void SetMaxDeadlockRetries(uint32 retries) { _maxDeadlockRetries.store(retries, std::memory_order_relaxed); }
+    [[nodiscard]] static inline uint32 GetMaxDeadlockRetries() { return _maxDeadlockRetries.load(std::memory_order_relaxed); }
+
 protected:
     void ExecuteQuery() override;
+
+    //! Transaction rolled back by a lost connection is executed again once the connection is back
     int32 TryExecute();
     void CleanupOnFailure();
 
+    //! Deadlocked transaction is executed again after the backoff delay.
+    //! Returns nullopt if the retry is queued (see Transaction::SetOrderDependent), otherwise the last error.
+    std::optional<int32> ExecuteWithDeadlockRetries();
+
     std::shared_ptr<Transaction> _trans;
-    static std::mutex _deadlockLock;
+    uint32 _deadlockRetries{};
+
+    static std::atomic<uint32> _maxDeadlockRetries;
 };
 
 class WH_DATABASE_API TransactionWithResultTask : public TransactionTask
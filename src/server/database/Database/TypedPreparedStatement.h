@@ -0,0 +1,173 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TYPED_PREPARED_STATEMENT_H
+#define _TYPED_PREPARED_STATEMENT_H
+
+#include "PreparedStatement.h"
+#include "StringFormat.h"
+#include <utility>
+
+/**
+    Compile time description of a prepared statement: index and types of parameters.
+
+    using DiscordInsNicknameStmt = Stmt<DISCORD_INS_NICKNAME, uint64, uint64, std::string_view, int32, std::string_view>;
+
+    Supported parameter types are arithmetic types, std::string_view and Binary (std::vector<uint8>).
+    Count of parameters is checked against the server when the statement is prepared.
+*/
+template<uint32 Index, typename... Params>
+struct Stmt
+{
+    static_assert(sizeof...(Params) <= 64, "Too many parameters for typed statement");
+    static_assert(((std::is_arithmetic_v<Params> || std::is_same_v<Params, std::string_view> || std::is_same_v<Params, std::vector<uint8>>) && ...),
+        "Unsupported parameter type for typed statement");
+
+    static constexpr uint32 StatementIndex = Index;
+    static constexpr uint8 ParamCount = sizeof...(Params);
+};
+
+namespace Warhead::Types
+{
+    //! Values of views are owned by the statement until it's executed
+    template<typename T>
+    struct StmtParamStorage { using type = T; };
+
+    template<>
+    struct StmtParamStorage<std::string_view> { using type = std::string; };
+
+    template<typename T>
+    using StmtParamStorage_t = typename StmtParamStorage<T>::type;
+
+    //! Arguments must have the exact type of the parameter, a value isn't narrowed or its sign changed silently.
+    //! Strings are only viewed, so any string type can be passed for std::string_view.
+    template<typename Arg, typename Param>
+    constexpr bool IsStmtArgument_v = std::is_same_v<std::remove_cvref_t<Arg>, Param> ||
+        (std::is_same_v<Param, std::string_view> && std::is_convertible_v<Arg, std::string_view>);
+}
+
+template<typename S>
+class TypedPreparedStatement;
+
+//- Prepared statement with parameter types checked at compile time.
+//- Values are kept in a tuple and bound straight to the MySQL statement, without std::variant and intermediate buffers.
+template<uint32 Index, typename... Params>
+class TypedPreparedStatement<Stmt<Index, Params...>> : public PreparedStatementBase
+{
+    using ValueTuple = std::tuple<Warhead::Types::StmtParamStorage_t<Params>...>;
+    static constexpr uint64 ALL_PARAMS_SET_MASK = sizeof...(Params) == 64 ? ~uint64(0) : (uint64(1) << sizeof...(Params)) - 1;
+
+public:
+    TypedPreparedStatement() : PreparedStatementBase(Index, 0) { }
+
+    // Set all
+    template<typename... Args>
+    void SetArguments(Args&&... args)
+    {
+        static_assert(sizeof...(Args) == sizeof...(Params), "Count of arguments doesn't match the typed statement");
+        static_assert((Warhead::Types::IsStmtArgument_v<Args, Params> && ...), "Argument type doesn't match the parameter of the typed statement, cast it explicitly");
+
+        SetAll(std::index_sequence_for<Params...>{}, std::forward<Args>(args)...);
+        _paramsSetMask = ALL_PARAMS_SET_MASK;
+    }
+
+    // Set one
+    template<std::size_t I, typename Arg>
+    void SetData(Arg&& value)
+    {
+        static_assert(Warhead::Types::IsStmtArgument_v<Arg, std::tuple_element_t<I, std::tuple<Params...>>>,
+            "Argument type doesn't match the parameter of the typed statement, cast it explicitly");
+
+        std::get<I>(_values) = std::forward<Arg>(value);
+        _paramsSetMask |= uint64(1) << I;
+    }
+
+    [[nodiscard]] std::pair<bool, uint8> IsAllParamsSet() const override
+    {
+        for (uint8 index{}; index < sizeof...(Params); index++)
+            if (!(_paramsSetMask & (uint64(1) << index)))
+                return { false, index };
+
+        return { true, {} };
+    }
+
+    bool BindParameters(PreparedStatementBinder& binder) const override
+    {
+        std::apply([&binder](auto const&... values)
+        {
+            uint8 index{ 0 };
+            (binder.Bind(index++, GetBindValue(values)), ...);
+        }, _values);
+
+        return true;
+    }
+
+    [[nodiscard]] uint8 GetParameterCount() const override { return sizeof...(Params); }
+
+    [[nodiscard]] std::string GetParameterString(uint8 index) const override
+    {
+        std::string result;
+
+        std::apply([&result, index](auto const&... values)
+        {
+            uint8 i{ 0 };
+            ((i++ == index ? void(result = ToString(values)) : void()), ...);
+        }, _values);
+
+        return result;
+    }
+
+    void AppendParameterKey(uint8 index, std::string& key) const override
+    {
+        std::apply([&key, index](auto const&... values)
+        {
+            uint8 i{ 0 };
+            ((i++ == index ? Warhead::Impl::AppendParameterKey(key, values) : void()), ...);
+        }, _values);
+    }
+
+private:
+    template<std::size_t... I, typename... Args>
+    void SetAll(std::index_sequence<I...>, Args&&... args)
+    {
+        // Assign to keep the capacity of strings
+        ((std::get<I>(_values) = std::forward<Args>(args)), ...);
+    }
+
+    template<typename T>
+    static inline decltype(auto) GetBindValue(T const& value)
+    {
+        if constexpr (std::is_same_v<T, std::string>)
+            return std::string_view{ value };
+        else
+            return (value);
+    }
+
+    template<typename T>
+    static inline std::string ToString(T const& value)
+    {
+        if constexpr (std::is_same_v<T, std::vector<uint8>>)
+            return "BINARY";
+        else
+            return Warhead::StringFormat("{}", value);
+    }
+
+    ValueTuple _values{};
+    uint64 _paramsSetMask{};
+};
+
+#endif
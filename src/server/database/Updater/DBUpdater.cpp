@@ -22,53 +22,16 @@
 #include "BuiltInConfig.h"
 #include "Config.h"
 #include "DatabaseEnv.h"
-#include "GitRevision.h"
+#include "FileUtil.h"
 #include "Log.h"
 #include "MySQLConnection.h"
 #include "ProgressBar.h"
-#include "StartProcess.h"
+#include "SQLScript.h"
 #include "UpdateFetcher.h"
-#include <fstream>
 #include <iostream>
 
 constexpr auto SQL_BASE_DIR = "/data/sql/base/";
 
-std::string DBUpdaterUtil::GetCorrectedMySQLExecutable()
-{
-    if (!corrected_path().empty())
-        return corrected_path();
-
-    return BuiltInConfig::GetMySQLExecutable();
-}
-
-bool DBUpdaterUtil::CheckExecutable()
-{
-    std::filesystem::path exe(GetCorrectedMySQLExecutable());
-    if (!is_regular_file(exe))
-    {
-        exe = Warhead::SearchExecutableInPath("mysql");
-        if (!exe.empty() && is_regular_file(exe))
-        {
-            // Correct the path to the cli
-            corrected_path() = absolute(exe).generic_string();
-            return true;
-        }
-
-        LOG_FATAL("db.update", "Didn't find any executable MySQL binary at \'{}\' or in path, correct the path in the *.conf (\"MySQLExecutable\").",
-            absolute(exe).generic_string());
-
-        return false;
-    }
-
-    return true;
-}
-
-std::string& DBUpdaterUtil::corrected_path()
-{
-    static std::string path;
-    return path;
-}
-
 std::string DBUpdater::GetConfigEntry(DatabaseWorkerPool const& pool)
 {
     return "Updates." + std::string{ pool.GetPoolName() };
@@ -114,43 +77,25 @@ bool DBUpdater::Create(DatabaseWorkerPool& pool)
 
     LOG_INFO("db.update", "Creating database \"{}\"...", pool.GetConnectionInfo()->Database);
 
-    // Path of temp file
-    static Path const temp("create_table.sql");
-
-    // Create temporary query to use external MySQL CLi
-    std::ofstream file(temp.generic_string());
-    if (!file.is_open())
-    {
-        LOG_FATAL("db.update", "Failed to create temporary query file \"{}\"!", temp.generic_string());
-        return false;
-    }
-
-    file << "CREATE DATABASE `" << pool.GetConnectionInfo()->Database << "` DEFAULT CHARACTER SET UTF8MB4 COLLATE utf8mb4_general_ci;\n\n";
-    file.close();
+    // Database doesn't exist yet, the connection is opened without it
+    MySQLConnectionInfo connectionInfo = *pool.GetConnectionInfo();
+    connectionInfo.Database.clear();
 
-    try
-    {
-        DBUpdater::ApplyFile(pool, pool.GetConnectionInfo()->Host, pool.GetConnectionInfo()->User, pool.GetConnectionInfo()->Password,
-            pool.GetConnectionInfo()->PortOrSocket, "", pool.GetConnectionInfo()->SSL, temp);
-    }
-    catch (UpdateException const&)
+    MySQLConnection connection(connectionInfo, nullptr);
+    if (connection.Open() || !connection.Execute(Warhead::StringFormat("CREATE DATABASE `{}` DEFAULT CHARACTER SET UTF8MB4 COLLATE utf8mb4_general_ci",
+        pool.GetConnectionInfo()->Database)))
     {
         LOG_FATAL("db.update", "Failed to create database {}! Does the user (named in *.conf) have `CREATE`, `ALTER`, `DROP`, `INSERT` and `DELETE` privileges on the MySQL server?", pool.GetConnectionInfo()->Database);
-        std::filesystem::remove(temp);
         return false;
     }
 
     LOG_INFO("db.update", "Done.");
     LOG_INFO("db.update", "");
-    std::filesystem::remove(temp);
     return true;
 }
 
 bool DBUpdater::Update(DatabaseWorkerPool& pool, std::string_view modulesList /*= {}*/)
 {
-    if (!DBUpdaterUtil::CheckExecutable())
-        return false;
-
     LOG_INFO("db.update", "Updating {} database...", DBUpdater::GetTableName(pool));
 
     Path const sourceDirectory(BuiltInConfig::GetSourceDirectory());
@@ -218,9 +163,6 @@ bool DBUpdater::Update(DatabaseWorkerPool& pool, std::string_view modulesList /*
 
 bool DBUpdater::Update(DatabaseWorkerPool& pool, std::vector<std::string> const* setDirectories)
 {
-    if (!DBUpdaterUtil::CheckExecutable())
-        return false;
-
     Path const sourceDirectory(BuiltInConfig::GetSourceDirectory());
     if (!is_directory(sourceDirectory))
         return false;
@@ -271,14 +213,12 @@ bool DBUpdater::Update(DatabaseWorkerPool& pool, std::vector<std::string> const*
 bool DBUpdater::Populate(DatabaseWorkerPool& pool)
 {
     {
+        // Streamed result has no row count until it's drained, but it's null if empty
         QueryResult const result = Retrieve(pool, "SHOW TABLES");
-        if (result && (result->GetRowCount() > 0))
+        if (result)
             return true;
     }
 
-    if (!DBUpdaterUtil::CheckExecutable())
-        return false;
-
     LOG_INFO("db.update", "Database {} is empty, auto populating it...", DBUpdater::GetTableName(pool));
 
     std::string const dirPathStr = DBUpdater::GetBaseFilesDirectory(pool);
@@ -339,7 +279,8 @@ bool DBUpdater::Populate(DatabaseWorkerPool& pool)
 
 QueryResult DBUpdater::Retrieve(DatabaseWorkerPool& pool, std::string_view query)
 {
-    return pool.Query(query);
+    // Updates table grows with every applied file, don't buffer it whole
+    return pool.QueryStream(query);
 }
 
 void DBUpdater::Apply(DatabaseWorkerPool& pool, std::string_view query)
@@ -349,70 +290,19 @@ void DBUpdater::Apply(DatabaseWorkerPool& pool, std::string_view query)
 
 void DBUpdater::ApplyFile(DatabaseWorkerPool& pool, Path const& path)
 {
-    DBUpdater::ApplyFile(pool, pool.GetConnectionInfo()->Host, pool.GetConnectionInfo()->User, pool.GetConnectionInfo()->Password,
-        pool.GetConnectionInfo()->PortOrSocket, pool.GetConnectionInfo()->Database, pool.GetConnectionInfo()->SSL, path);
-}
-
-void DBUpdater::ApplyFile(DatabaseWorkerPool& pool, std::string_view host, std::string_view user, std::string_view password,
-    std::string_view port_or_socket, std::string_view database, std::string_view ssl, Path const& path)
-{
-    std::vector<std::string> args;
-    args.reserve(9);
-
-    // Add password from extra file
-    args.emplace_back(Warhead::StringFormat("--defaults-extra-file={}", pool.GetPathToExtraFile()));
-
-    // CLI Client connection info
-    args.emplace_back("-h" + std::string{ host });
-    args.emplace_back("-u" + std::string{ user });
-
-    // Check if we want to connect through ip or socket (Unix only)
-#if WARHEAD_PLATFORM == WARHEAD_PLATFORM_WINDOWS
-    if (host == ".")
-        args.emplace_back("--protocol=PIPE");
-    else
-        args.emplace_back("-P" + std::string{ port_or_socket });
-#else
-
-    if (!std::isdigit(port_or_socket[0]))
+    Warhead::File::MappedFile file;
+    if (!file.Open(path))
     {
-        // We can't check if host == "." here, because it is named localhost if socket option is enabled
-        args.emplace_back("-P0");
-        args.emplace_back("--protocol=SOCKET");
-        args.emplace_back("-S" + std::string{ port_or_socket });
-    }
-    else
-        // generic case
-        args.emplace_back("-P" + std::string{ port_or_socket });
-#endif
+        LOG_FATAL("db.update", "Failed to open the sql file \"{}\" for reading! "
+            "Stopping the server to keep the database integrity, "
+            "try to identify and solve the issue or disable the database updater.",
+            path.generic_string());
 
-    // Set the default charset to utf8
-    args.emplace_back("--default-character-set=utf8mb4");
-
-    // Set max allowed packet to 1 GB
-    args.emplace_back("--max-allowed-packet=1GB");
-
-#if !defined(MARIADB_VERSION_ID) && MYSQL_VERSION_ID >= 80000
-    if (ssl == "ssl")
-        args.emplace_back("--ssl-mode=REQUIRED");
-#else
-    if (ssl == "ssl")
-        args.emplace_back("--ssl");
-#endif
-
-    // Execute sql file
-    args.emplace_back("-e");
-    args.emplace_back(Warhead::StringFormat("BEGIN; SOURCE {}; COMMIT;", path.generic_string()));
-
-    // Database
-    if (!database.empty())
-        args.emplace_back(database);
-
-    // Invokes a mysql process which doesn't leak credentials to logs
-    int const ret = Warhead::StartProcess(DBUpdaterUtil::GetCorrectedMySQLExecutable(), args,
-        "db.update", "", true);
+        throw UpdateException("Opening the sql file failed!");
+    }
 
-    if (ret != EXIT_SUCCESS)
+    // Executed in process over a temporary connection, like SOURCE of the mysql client in one transaction
+    if (!pool.DirectExecuteScript(Warhead::SQLScript::Split(file.GetView())))
     {
         LOG_FATAL("db.update", "Applying of file \'{}\' to database \'{}\' failed!" \
             " If you are a user, please pull the latest revision from the repository. "
@@ -38,16 +38,6 @@ private:
     std::string _msg;
 };
 
-class WH_DATABASE_API DBUpdaterUtil
-{
-public:
-    static std::string GetCorrectedMySQLExecutable();
-    static bool CheckExecutable();
-
-private:
-    static std::string& corrected_path();
-};
-
 class WH_DATABASE_API DBUpdater
 {
 public:
@@ -69,8 +59,6 @@ private:
     static QueryResult Retrieve(DatabaseWorkerPool& pool, std::string_view query);
     static void Apply(DatabaseWorkerPool& pool, std::string_view query);
     static void ApplyFile(DatabaseWorkerPool& pool, Path const& path);
-    static void ApplyFile(DatabaseWorkerPool& pool, std::string_view host, std::string_view user,
-        std::string_view password, std::string_view port_or_socket, std::string_view database, std::string_view ssl, Path const& path);
 };
 
 #endif // DBUpdater_h__
@@ -0,0 +1,174 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "SQLScript.h"
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+    constexpr std::string_view DEFAULT_DELIMITER = ";";
+    constexpr std::string_view DELIMITER_COMMAND = "DELIMITER";
+
+    inline bool IsSpace(char c)
+    {
+        return std::isspace(static_cast<unsigned char>(c)) != 0;
+    }
+
+    inline std::size_t FindLineEnd(std::string_view script, std::size_t pos)
+    {
+        std::size_t end = script.find('\n', pos);
+        return end == std::string_view::npos ? script.size() : end;
+    }
+
+    //! Position after the closing quote, backslash escapes the next character in strings
+    std::size_t SkipQuoted(std::string_view script, std::size_t pos)
+    {
+        char const quote = script[pos++];
+
+        while (pos < script.size())
+        {
+            char const c = script[pos++];
+
+            if (c == '\\' && quote != '`')
+                ++pos;
+            else if (c == quote)
+                break;
+        }
+
+        return std::min(pos, script.size());
+    }
+
+    //! Length of the DELIMITER command at pos, 0 if there is none. The new delimiter is set if there is one.
+    std::size_t ParseDelimiterCommand(std::string_view script, std::size_t pos, std::string_view& delimiter)
+    {
+        std::string_view command = script.substr(pos, DELIMITER_COMMAND.size());
+        if (command.size() != DELIMITER_COMMAND.size() || pos + command.size() >= script.size() || !IsSpace(script[pos + command.size()]))
+            return 0;
+
+        for (std::size_t i = 0; i < command.size(); ++i)
+            if (std::toupper(static_cast<unsigned char>(command[i])) != DELIMITER_COMMAND[i])
+                return 0;
+
+        std::size_t const end = FindLineEnd(script, pos);
+        std::string_view value = script.substr(pos + command.size(), end - pos - command.size());
+
+        while (!value.empty() && IsSpace(value.front()))
+            value.remove_prefix(1);
+
+        // Delimiter ends at the first space like in the client
+        std::size_t valueEnd = 0;
+        while (valueEnd < value.size() && !IsSpace(value[valueEnd]))
+            ++valueEnd;
+
+        if (valueEnd)
+            delimiter = value.substr(0, valueEnd);
+
+        return end - pos;
+    }
+}
+
+std::vector<std::string_view> Warhead::SQLScript::Split(std::string_view script)
+{
+    std::vector<std::string_view> statements;
+    std::string_view delimiter = DEFAULT_DELIMITER;
+
+    // Statement is [codeBegin, codeEnd), npos until code of a statement is found
+    std::size_t codeBegin = std::string_view::npos;
+    std::size_t codeEnd = 0;
+    bool isLineStart = true;
+
+    auto AddCode = [&codeBegin, &codeEnd](std::size_t begin, std::size_t end)
+    {
+        if (codeBegin == std::string_view::npos)
+            codeBegin = begin;
+
+        codeEnd = end;
+    };
+
+    std::size_t pos = 0;
+
+    while (pos < script.size())
+    {
+        char const c = script[pos];
+
+        // Client command, only recognized before code of a statement
+        if (isLineStart && codeBegin == std::string_view::npos && !IsSpace(c))
+        {
+            if (std::size_t const length = ParseDelimiterCommand(script, pos, delimiter))
+            {
+                pos += length;
+                continue;
+            }
+        }
+
+        isLineStart = c == '\n';
+
+        if (IsSpace(c))
+        {
+            ++pos;
+            continue;
+        }
+
+        // Quotes and comments are skipped whole below, so the delimiter is only matched outside of them
+        if (script.compare(pos, delimiter.size(), delimiter) == 0)
+        {
+            if (codeBegin != std::string_view::npos)
+                statements.emplace_back(script.substr(codeBegin, codeEnd - codeBegin));
+
+            codeBegin = std::string_view::npos;
+            pos += delimiter.size();
+            continue;
+        }
+
+        char const next = pos + 1 < script.size() ? script[pos + 1] : '\0';
+
+        if (c == '\'' || c == '"' || c == '`')
+        {
+            std::size_t const end = SkipQuoted(script, pos);
+            AddCode(pos, end);
+            pos = end;
+        }
+        else if (c == '#' || (c == '-' && next == '-' && (pos + 2 >= script.size() || IsSpace(script[pos + 2]))))
+            pos = FindLineEnd(script, pos);
+        else if (c == '/' && next == '*')
+        {
+            std::size_t end = script.find("*/", pos + 2);
+            end = end == std::string_view::npos ? script.size() : end + 2;
+
+            // Executed by the server
+            if (pos + 2 < script.size() && (script[pos + 2] == '!' || script[pos + 2] == '+'))
+                AddCode(pos, end);
+
+            pos = end;
+        }
+        else
+        {
+            AddCode(pos, pos + 1);
+            ++pos;
+        }
+    }
+
+    // Last statement doesn't need a delimiter
+    if (codeBegin != std::string_view::npos)
+        statements.emplace_back(script.substr(codeBegin, codeEnd - codeBegin));
+
+    return statements;
+}
@@ -0,0 +1,38 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SQL_SCRIPT_H_
+#define _SQL_SCRIPT_H_
+
+#include "Define.h"
+#include <string_view>
+#include <vector>
+
+namespace Warhead::SQLScript
+{
+    /**
+        Splits a script of the mysql client into statements the server can execute, as the client does for SOURCE.
+
+        Statements end at the delimiter outside of quotes and comments. DELIMITER commands of the client
+        change it and aren't returned, so bodies of routines and triggers are returned whole.
+        Statements are views into the script without the delimiter and the comments around it,
+        comments which are executed by the server (version comments and optimizer hints) are kept.
+    */
+    WH_DATABASE_API std::vector<std::string_view> Split(std::string_view script);
+}
+
+#endif
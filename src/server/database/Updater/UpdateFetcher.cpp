@@ -23,13 +23,17 @@
 #include "CryptoHash.h"
 #include "DBUpdater.h"
 #include "Field.h"
+#include "FileUtil.h"
 #include "Log.h"
 #include "ProgressBar.h"
 #include "StopWatch.h"
+#include "ThreadPool.h"
 #include "Tokenize.h"
+#include "UpdateHashCache.h"
 #include "Util.h"
+#include <atomic>
 #include <filesystem>
-#include <fstream>
+#include <optional>
 #include <sstream>
 #include <utility>
 
@@ -205,6 +209,9 @@ UpdateFetcher::AppliedFileStorage UpdateFetcher::ReceiveAppliedFiles() const
 {
     AppliedFileStorage map;
 
+    // Not served from the hash cache: the table is changed by other tools and other runs (e.g. a restored dump),
+    // and no cheap query tells whether it did. Row count and latest timestamp miss a rehash or a manual UPDATE in the same second.
+    // All rows come in one round trip, which costs less than hashing the files the cache avoids.
     QueryResult result = _retrieve("SELECT `name`, `hash`, `state`, UNIX_TIMESTAMP(`timestamp`) FROM `updates` ORDER BY `name` ASC");
     if (!result)
         return map;
@@ -219,28 +226,93 @@ UpdateFetcher::AppliedFileStorage UpdateFetcher::ReceiveAppliedFiles() const
     return map;
 }
 
-std::string UpdateFetcher::ReadSQLUpdate(Path const& file)
+UpdateFetcher::Path UpdateFetcher::GetHashCachePath() const
 {
-    std::ifstream in(file.c_str());
-    if (!in.is_open())
+    std::string name = _dbModuleName;
+    while (!name.empty() && name.back() == '/')
+        name.pop_back();
+
+    Path path(sConfigMgr->GetConfigPath());
+    path /= "DB";
+    path /= name + ".hashes";
+    return path;
+}
+
+UpdateFetcher::FileNameToHashStorage UpdateFetcher::HashUpdates(LocaleFileStorage const& available, AppliedFileStorage const& applied,
+    bool redundancyChecks, bool archivedRedundancy, UpdateHashCache* cache)
+{
+    FileNameToHashStorage hashes;
+    std::vector<Path const*> files;
+    std::vector<std::optional<UpdateHashCache::FileStamp>> stamps;
+    files.reserve(available.size());
+    stamps.reserve(available.size());
+
+    for (auto const& [path, state] : available)
     {
-        LOG_FATAL("db.update", "Failed to open the sql update \"{}\" for reading! "
-                  "Stopping the server to keep the database integrity, "
-                  "try to identify and solve the issue or disable the database updater.",
-                  file.generic_string());
+        auto const& iter = applied.find(path.filename().string());
+        if (iter != applied.end() && (!redundancyChecks || (!archivedRedundancy && iter->second.state == ARCHIVED && state == ARCHIVED)))
+            continue;
 
-        throw UpdateException("Opening the sql update failed!");
+        auto stamp = cache ? UpdateHashCache::GetStamp(path) : std::nullopt;
+        if (stamp)
+        {
+            if (std::string const* hash = cache->Find(path, *stamp))
+            {
+                hashes.emplace(path.filename().string(), *hash);
+                continue;
+            }
+        }
+
+        files.emplace_back(&path);
+        stamps.emplace_back(stamp);
+    }
+
+    LOG_DEBUG("db.update", "> {} update files are hashed, {} hashes are cached", files.size(), hashes.size());
+
+    if (files.empty())
+        return hashes;
+
+    std::vector<std::string> digests(files.size());
+    std::atomic<bool> failed{};
+
+    {
+        Warhead::ThreadPool threadPool(std::min<std::size_t>(files.size(), std::max(std::thread::hardware_concurrency(), 1u)));
+
+        for (std::size_t i = 0; i < files.size(); ++i)
+        {
+            threadPool.PostWork([&files, &digests, &failed, i]()
+            {
+                Warhead::File::MappedFile file;
+                if (!file.Open(*files[i]))
+                {
+                    LOG_FATAL("db.update", "Failed to open the sql update \"{}\" for reading! "
+                        "Stopping the server to keep the database integrity, "
+                        "try to identify and solve the issue or disable the database updater.",
+                        files[i]->generic_string());
+
+                    failed = true;
+                    return;
+                }
+
+                digests[i] = ByteArrayToHexStr(Warhead::Crypto::SHA1::GetDigestOf(file.GetView()));
+            });
+        }
+
+        threadPool.Wait();
     }
 
-    auto update = [&in]
+    if (failed)
+        throw UpdateException("Opening the sql update failed!");
+
+    for (std::size_t i = 0; i < files.size(); ++i)
     {
-        std::ostringstream ss;
-        ss << in.rdbuf();
-        return ss.str();
-    }();
+        if (cache && stamps[i])
+            cache->Store(*files[i], *stamps[i], digests[i]);
 
-    in.close();
-    return update;
+        hashes.emplace(files[i]->filename().string(), std::move(digests[i]));
+    }
+
+    return hashes;
 }
 
 UpdateResult UpdateFetcher::Update() const
@@ -270,12 +342,27 @@ UpdateResult UpdateFetcher::Update() const
 
     size_t importedUpdates = 0;
 
-    auto ApplyUpdateFile = [this, &applied, &hashToName, &available, &importedUpdates](Path const& filePath, State const& fileState, ProgressBar const& progress)
+    bool const redundancyChecks = sConfigMgr->GetOption<bool>("Updates.Redundancy", true);
+    bool const allowRehash = sConfigMgr->GetOption<bool>("Updates.AllowRehash", true);
+    bool const archivedRedundancy = sConfigMgr->GetOption<bool>("Updates.ArchivedRedundancy", false);
+
+    // Files unchanged since the last run aren't read again
+    std::optional<UpdateHashCache> hashCache;
+    if (sConfigMgr->GetOption<bool>("Updates.HashCache", true))
     {
-        bool const redundancyChecks = sConfigMgr->GetOption<bool>("Updates.Redundancy", true);
-        bool const allowRehash = sConfigMgr->GetOption<bool>("Updates.AllowRehash", true);
-        bool const archivedRedundancy = sConfigMgr->GetOption<bool>("Updates.ArchivedRedundancy", false);
+        hashCache.emplace(GetHashCachePath());
+        hashCache->Load();
+    }
+
+    // Reading and hashing is done up front on all cores, updates are still applied one by one in order
+    FileNameToHashStorage const hashes = HashUpdates(available, applied, redundancyChecks, archivedRedundancy, hashCache ? &*hashCache : nullptr);
 
+    if (hashCache)
+        hashCache->Save();
+
+    auto ApplyUpdateFile = [this, &applied, &hashToName, &available, &hashes, &importedUpdates, redundancyChecks, allowRehash, archivedRedundancy]
+        (Path const& filePath, State const& fileState, ProgressBar const& progress)
+    {
         auto const& iter = applied.find(filePath.filename().string());
         if (iter != applied.end())
         {
@@ -294,7 +381,9 @@ UpdateResult UpdateFetcher::Update() const
             }
         }
 
-        std::string const hash = ByteArrayToHexStr(Warhead::Crypto::SHA1::GetDigestOf(ReadSQLUpdate(filePath)));
+        auto const& digestIter = hashes.find(filePath.filename().string());
+        ASSERT(digestIter != hashes.end());
+        std::string const& hash = digestIter->second;
 
         UpdateMode mode = MODE_APPLY;
 
@@ -27,6 +27,8 @@
 #include <utility>
 #include <vector>
 
+class UpdateHashCache;
+
 struct WH_DATABASE_API UpdateResult
 {
     UpdateResult() = default;
@@ -130,6 +132,7 @@ private:
 
     typedef std::set<LocaleFileEntry, PathCompare> LocaleFileStorage;
     typedef std::unordered_map<std::string, std::string> HashToFileNameStorage;
+    typedef std::unordered_map<std::string, std::string> FileNameToHashStorage;
     typedef std::unordered_map<std::string, AppliedFileEntry> AppliedFileStorage;
     typedef std::vector<UpdateFetcher::DirectoryEntry> DirectoryStorage;
 
@@ -140,7 +143,11 @@ private:
     [[nodiscard]] DirectoryStorage ReceiveIncludedDirectories() const;
     [[nodiscard]] AppliedFileStorage ReceiveAppliedFiles() const;
 
-    [[nodiscard]] static std::string ReadSQLUpdate(Path const& file) ;
+    //! Files are mapped and hashed on a thread pool, files skipped by the redundancy checks or found in the cache aren't hashed
+    [[nodiscard]] static FileNameToHashStorage HashUpdates(LocaleFileStorage const& available, AppliedFileStorage const& applied,
+        bool redundancyChecks, bool archivedRedundancy, UpdateHashCache* cache);
+
+    [[nodiscard]] Path GetHashCachePath() const;
 
     [[nodiscard]] Milliseconds Apply(Path const& path) const;
 
@@ -0,0 +1,176 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "UpdateHashCache.h"
+#include "FileUtil.h"
+#include "Log.h"
+#include "StringConvert.h"
+#include <fstream>
+
+#if WARHEAD_PLATFORM != WARHEAD_PLATFORM_WINDOWS
+#include <sys/stat.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // First line of the file, cache of another format is ignored
+    constexpr std::string_view CACHE_HEADER = "WarheadCore update hashes v1";
+
+    // Modification is only visible if the file changed after the timestamp tick it was hashed in
+    constexpr auto RACY_INTERVAL = std::chrono::seconds(2);
+
+    //! Splits the next field ending at a space off the line
+    std::string_view TakeField(std::string_view& line)
+    {
+        std::size_t const end = line.find(' ');
+        std::string_view field = line.substr(0, end);
+        line = end == std::string_view::npos ? std::string_view{} : line.substr(end + 1);
+        return field;
+    }
+}
+
+void UpdateHashCache::Load()
+{
+    _entries.clear();
+
+    std::ifstream in(_file);
+    if (!in.is_open())
+        return;
+
+    std::string line;
+    if (!std::getline(in, line) || line != CACHE_HEADER)
+    {
+        LOG_WARN("db.update", "> Update hash cache \"{}\" has unknown format, files are hashed again", _file.generic_string());
+        return;
+    }
+
+    // hash size time inode path, path is last as it can contain spaces
+    while (std::getline(in, line))
+    {
+        std::string_view rest = line;
+        std::string_view hash = TakeField(rest);
+        auto size = Warhead::StringTo<uint64>(TakeField(rest));
+        auto time = Warhead::StringTo<int64>(TakeField(rest));
+        auto inode = Warhead::StringTo<uint64>(TakeField(rest));
+
+        if (hash.empty() || !size || !time || !inode || rest.empty())
+        {
+            LOG_WARN("db.update", "> Update hash cache \"{}\" is corrupted, files are hashed again", _file.generic_string());
+            _entries.clear();
+            return;
+        }
+
+        _entries.insert_or_assign(std::string(rest), Entry{ { *size, *time, *inode }, std::string(hash) });
+    }
+}
+
+bool UpdateHashCache::Save() const
+{
+    if (_file.has_parent_path() && !Warhead::File::CreateDirIfNeed(_file.parent_path().generic_string()))
+        return false;
+
+    Path temp = _file;
+    temp += ".tmp";
+
+    {
+        std::ofstream out(temp, std::ios::trunc);
+        if (!out.is_open())
+        {
+            LOG_WARN("db.update", "> Failed to write update hash cache \"{}\"", temp.generic_string());
+            return false;
+        }
+
+        out << CACHE_HEADER << '\n';
+
+        for (auto const& [path, entry] : _entries)
+        {
+            std::error_code error;
+            if (!fs::exists(path, error))
+                continue;
+
+            out << entry.Hash << ' ' << entry.Stamp.Size << ' ' << entry.Stamp.ModifiedTime << ' ' << entry.Stamp.Inode << ' ' << path << '\n';
+        }
+
+        if (!out.flush())
+        {
+            LOG_WARN("db.update", "> Failed to write update hash cache \"{}\"", temp.generic_string());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    fs::rename(temp, _file, error);
+    if (error)
+    {
+        LOG_WARN("db.update", "> Failed to replace update hash cache \"{}\": {}", _file.generic_string(), error.message());
+        fs::remove(temp, error);
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<UpdateHashCache::FileStamp> UpdateHashCache::GetStamp(Path const& path)
+{
+    std::error_code error;
+    FileStamp stamp;
+
+    stamp.Size = fs::file_size(path, error);
+    if (error)
+        return std::nullopt;
+
+    stamp.ModifiedTime = fs::last_write_time(path, error).time_since_epoch().count();
+    if (error)
+        return std::nullopt;
+
+#if WARHEAD_PLATFORM != WARHEAD_PLATFORM_WINDOWS
+    // Catches a file replaced by another one of the same size and time, e.g. by a checkout
+    struct stat info{};
+    if (!::stat(path.c_str(), &info))
+        stamp.Inode = static_cast<uint64>(info.st_ino);
+#endif
+
+    return stamp;
+}
+
+std::string const* UpdateHashCache::Find(Path const& path, FileStamp const& stamp) const
+{
+    auto itr = _entries.find(path.generic_string());
+    if (itr == _entries.end() || itr->second.Stamp != stamp)
+        return nullptr;
+
+    return &itr->second.Hash;
+}
+
+void UpdateHashCache::Store(Path const& path, FileStamp const& stamp, std::string_view hash)
+{
+    std::string key = path.generic_string();
+
+    auto const modified = fs::file_time_type(fs::file_time_type::duration(stamp.ModifiedTime));
+    if (fs::file_time_type::clock::now() - modified < RACY_INTERVAL)
+    {
+        _entries.erase(key);
+        return;
+    }
+
+    _entries.insert_or_assign(std::move(key), Entry{ stamp, std::string(hash) });
+}
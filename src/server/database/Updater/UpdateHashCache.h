@@ -0,0 +1,74 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _UPDATE_HASH_CACHE_H_
+#define _UPDATE_HASH_CACHE_H_
+
+#include "Define.h"
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+    Hashes of update files computed by the previous runs, stored in a file next to the configs.
+
+    A file is only hashed again if its size, modification time or inode changed, so startup doesn't
+    read every update file. Files modified just before they were hashed aren't cached, a change
+    in the same timestamp tick wouldn't be noticed otherwise.
+*/
+class WH_DATABASE_API UpdateHashCache
+{
+public:
+    using Path = std::filesystem::path;
+
+    struct FileStamp
+    {
+        uint64 Size{};
+        int64 ModifiedTime{}; ///< Ticks of std::filesystem::file_time_type
+        uint64 Inode{}; ///< 0 where the file system doesn't have one
+
+        bool operator==(FileStamp const& right) const = default;
+    };
+
+    explicit UpdateHashCache(Path file) : _file(std::move(file)) { }
+
+    //! Missing, unreadable or outdated cache file is treated as empty
+    void Load();
+
+    //! Entries of files which don't exist anymore are dropped. Cache is written to a temporary file and renamed.
+    bool Save() const;
+
+    [[nodiscard]] static std::optional<FileStamp> GetStamp(Path const& path);
+
+    //! nullptr if the file isn't cached or changed since it was hashed
+    [[nodiscard]] std::string const* Find(Path const& path, FileStamp const& stamp) const;
+    void Store(Path const& path, FileStamp const& stamp, std::string_view hash);
+
+private:
+    struct Entry
+    {
+        FileStamp Stamp;
+        std::string Hash;
+    };
+
+    Path _file;
+    std::unordered_map<std::string, Entry> _entries; ///< By generic path of the file
+};
+
+#endif
@@ -0,0 +1,46 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "BenchDatabase.h"
+#include "QueryResult.h"
+
+bool BenchDatabasePool::CreateTable()
+{
+    DirectExecute("DROP TABLE IF EXISTS `{}`", BENCH_TABLE_NAME);
+    DirectExecute("CREATE TABLE `{}` (`id` INT UNSIGNED NOT NULL AUTO_INCREMENT, `value` INT UNSIGNED NOT NULL, `name` VARCHAR(32) NOT NULL, "
+        "PRIMARY KEY (`id`)) ENGINE = InnoDB", BENCH_TABLE_NAME);
+
+    return Query("SHOW TABLES LIKE '{}'", BENCH_TABLE_NAME) != nullptr;
+}
+
+void BenchDatabasePool::DropTable()
+{
+    DirectExecute("DROP TABLE IF EXISTS `{}`", BENCH_TABLE_NAME);
+}
+
+void BenchDatabasePool::DoPrepareStatements()
+{
+    SetStatementSize(MAX_BENCH_DATABASE_STATEMENTS);
+
+    PrepareStatement<BenchSelRowStmt>("SELECT `id`, `value`, `name` FROM `dbbench_rows` WHERE `id` = ?", ConnectionFlags::Both);
+    PrepareStatement<BenchSelRowsStmt>("SELECT `id`, `value`, `name` FROM `dbbench_rows` ORDER BY `id` LIMIT ?", ConnectionFlags::Sync);
+    PrepareStatement<BenchInsRowStmt>("INSERT INTO `dbbench_rows` (`value`, `name`) VALUES (?, ?)", ConnectionFlags::Async);
+    PrepareStatement<BenchUpdValueStmt>("UPDATE `dbbench_rows` SET `value` = `value` + 1 WHERE `id` = ?", ConnectionFlags::Both);
+}
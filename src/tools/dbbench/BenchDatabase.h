@@ -0,0 +1,55 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BENCH_DATABASE_H_
+#define _BENCH_DATABASE_H_
+
+#include "DatabaseWorkerPool.h"
+#include "TypedPreparedStatement.h"
+
+//! Scratch table of the benchmark, created on start and dropped when it's done
+constexpr auto BENCH_TABLE_NAME = "dbbench_rows";
+
+enum BenchDatabaseStatements : uint32
+{
+    BENCH_SEL_ROW,
+    BENCH_SEL_ROWS,
+    BENCH_INS_ROW,
+    BENCH_UPD_VALUE,
+
+    MAX_BENCH_DATABASE_STATEMENTS
+};
+
+using BenchSelRowStmt   = Stmt<BENCH_SEL_ROW, uint32>;
+using BenchSelRowsStmt  = Stmt<BENCH_SEL_ROWS, uint32>;
+using BenchInsRowStmt   = Stmt<BENCH_INS_ROW, uint32, std::string_view>;
+using BenchUpdValueStmt = Stmt<BENCH_UPD_VALUE, uint32>;
+
+class BenchDatabasePool : public DatabaseWorkerPool
+{
+public:
+    BenchDatabasePool() : DatabaseWorkerPool(DatabaseType::None) { }
+    ~BenchDatabasePool() = default;
+
+    //! Creates the scratch table, must be called before the statements are prepared
+    bool CreateTable();
+    void DropTable();
+
+    void DoPrepareStatements() override;
+};
+
+#endif
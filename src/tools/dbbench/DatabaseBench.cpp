@@ -0,0 +1,329 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "DatabaseBench.h"
+#include "BenchDatabase.h"
+#include "Field.h"
+#include "MySQLWorkaround.h"
+#include "QueryCallbackProcessor.h"
+#include "QueryResult.h"
+#include "QueryStatistics.h"
+#include "Random.h"
+#include "Transaction.h"
+#include <atomic>
+#include <latch>
+#include <memory>
+#include <thread>
+
+namespace
+{
+    // Writes are executed when the row count reaches the expected one, the case gives up after the timeout
+    constexpr Milliseconds DRAIN_POLL_INTERVAL = 10ms;
+    constexpr Minutes DRAIN_TIMEOUT = 5min;
+
+    // Rows inserted by one seed query
+    constexpr uint32 SEED_BATCH_ROWS = 1000;
+
+    // Times every result set is fetched
+    constexpr uint32 RESULT_SET_RUNS = 3;
+
+    inline TimePoint Now() { return std::chrono::steady_clock::now(); }
+
+    inline Microseconds GetElapsed(TimePoint begin) { return std::chrono::duration_cast<Microseconds>(Now() - begin); }
+}
+
+template<typename Operation>
+void DatabaseBench::RunProducers(std::string_view name, uint32 threads, Operation&& operation, std::function<void()> const& drain /*= {}*/)
+{
+    uint32 iterations = std::max<uint32>(_operations / threads, 1);
+
+    LatencyHistogram latency;
+    std::atomic<uint64> errors{};
+    std::latch start(threads + 1);
+
+    std::vector<std::thread> producers;
+    producers.reserve(threads);
+
+    for (uint32 thread = 0; thread < threads; ++thread)
+    {
+        producers.emplace_back([&, thread]()
+        {
+            start.arrive_and_wait();
+
+            for (uint32 i = 0; i < iterations; ++i)
+            {
+                TimePoint begin = Now();
+
+                if (!operation(thread, i))
+                    errors.fetch_add(1, std::memory_order_relaxed);
+
+                latency.Add(GetElapsed(begin));
+            }
+
+            mysql_thread_end();
+        });
+    }
+
+    TimePoint begin = Now();
+    start.arrive_and_wait();
+
+    for (auto& producer : producers)
+        producer.join();
+
+    if (drain)
+        drain();
+
+    AddResult(name, threads, uint64(iterations) * threads, errors.load(), GetElapsed(begin), latency);
+}
+
+void DatabaseBench::Seed(uint32 rows)
+{
+    uint64 count = GetRowCount();
+
+    // Rows of one statement get consecutive ids, so ids of seeded rows are [1, rows]
+    while (count < rows)
+    {
+        uint32 batch = std::min<uint64>(rows - count, SEED_BATCH_ROWS);
+
+        fmt::memory_buffer query;
+        fmt::format_to(std::back_inserter(query), "INSERT INTO `{}` (`value`, `name`) VALUES ", BENCH_TABLE_NAME);
+
+        for (uint32 i = 0; i < batch; ++i)
+            fmt::format_to(std::back_inserter(query), "{}({}, 'row{}')", i ? ", " : "", count + i, count + i);
+
+        _pool.DirectExecute(std::string_view(query.data(), query.size()));
+
+        uint64 newCount = GetRowCount();
+        if (newCount <= count)
+        {
+            fmt::print(stderr, "> Failed to seed table `{}`, stopped at {} rows\n", BENCH_TABLE_NAME, count);
+            break;
+        }
+
+        count = newCount;
+    }
+
+    _seededRows = std::max<uint64>(std::min<uint64>(count, rows), 1);
+}
+
+void DatabaseBench::RunExecute(uint32 threads)
+{
+    uint64 expectedRows = GetRowCount() + uint64(std::max<uint32>(_operations / threads, 1)) * threads;
+
+    RunProducers("execute", threads, [this](uint32 /*thread*/, uint32 iteration)
+    {
+        auto stmt = _pool.GetPreparedStatement<BenchInsRowStmt>();
+        stmt->SetArguments(iteration, "execute");
+        _pool.Execute(stmt);
+        return true;
+    }, [this, expectedRows]()
+    {
+        // Throughput counts until the writes are executed, not until they are queued
+        TimePoint deadline = Now() + DRAIN_TIMEOUT;
+
+        while (GetRowCount() < expectedRows && Now() < deadline)
+            std::this_thread::sleep_for(DRAIN_POLL_INTERVAL);
+    });
+}
+
+void DatabaseBench::RunAsyncQuery(uint32 threads)
+{
+    auto processors = std::make_unique<QueryCallbackProcessor[]>(threads);
+
+    RunProducers("async_query", threads, [this, &processors](uint32 thread, uint32 /*iteration*/)
+    {
+        QueryCallbackProcessor& processor = processors[thread];
+
+        auto stmt = _pool.GetPreparedStatement<BenchSelRowStmt>();
+        stmt->SetArguments(urand(1, _seededRows));
+
+        bool done{};
+        bool found{};
+
+        processor.AddCallback(_pool.AsyncQuery(stmt).WithPreparedCallback([&done, &found](PreparedQueryResult result)
+        {
+            found = result != nullptr;
+            done = true;
+        }));
+
+        for (;;)
+        {
+            processor.ProcessReadyCallbacks();
+            if (done)
+                break;
+
+            processor.WaitForCompletion(DRAIN_POLL_INTERVAL);
+        }
+
+        return found;
+    });
+}
+
+void DatabaseBench::RunQuery(uint32 threads)
+{
+    RunProducers("query", threads, [this](uint32 /*thread*/, uint32 /*iteration*/)
+    {
+        auto stmt = _pool.GetPreparedStatement<BenchSelRowStmt>();
+        stmt->SetArguments(urand(1, _seededRows));
+        return _pool.Query(stmt) != nullptr;
+    });
+}
+
+void DatabaseBench::RunTransaction(uint32 threads)
+{
+    RunProducers("transaction", threads, [this](uint32 /*thread*/, uint32 /*iteration*/)
+    {
+        auto trans = _pool.BeginTransaction();
+
+        for (uint32 i = 0; i < 2; ++i)
+        {
+            auto stmt = _pool.GetPreparedStatement<BenchUpdValueStmt>();
+            stmt->SetArguments(urand(1, _seededRows));
+            trans->Append(stmt);
+        }
+
+        return _pool.AsyncCommitTransaction(trans)._future.get();
+    });
+}
+
+void DatabaseBench::RunDeadlock(uint32 threads)
+{
+    uint64 deadlocks = GetDeadlockCount();
+
+    RunProducers("deadlock", threads, [this](uint32 thread, uint32 /*iteration*/)
+    {
+        // Half of the producers lock the rows in opposite order
+        uint32 first = thread % 2 ? 2 : 1;
+
+        auto trans = _pool.BeginTransaction();
+
+        for (uint32 id : { first, 3 - first })
+        {
+            auto stmt = _pool.GetPreparedStatement<BenchUpdValueStmt>();
+            stmt->SetArguments(id);
+            trans->Append(stmt);
+        }
+
+        return _pool.AsyncCommitTransaction(trans)._future.get();
+    });
+
+    _results.back().Deadlocks = GetDeadlockCount() - deadlocks;
+}
+
+void DatabaseBench::RunResultSet(uint32 rows)
+{
+    Seed(rows);
+
+    for (bool prepared : { false, true })
+    {
+        LatencyHistogram latency;
+        uint64 decoded{};
+        TimePoint begin = Now();
+
+        for (uint32 run = 0; run < RESULT_SET_RUNS; ++run)
+        {
+            TimePoint runBegin = Now();
+
+            if (prepared)
+            {
+                auto stmt = _pool.GetPreparedStatement<BenchSelRowsStmt>();
+                stmt->SetArguments(rows);
+
+                if (PreparedQueryResult result = _pool.Query(stmt))
+                {
+                    do
+                    {
+                        auto fields = result->Fetch();
+                        _checksum += fields[0].Get<uint32>() + fields[1].Get<uint32>() + fields[2].Get<std::string_view>().size();
+                        ++decoded;
+                    } while (result->NextRow());
+                }
+            }
+            else if (QueryResult result = _pool.Query("SELECT `id`, `value`, `name` FROM `{}` ORDER BY `id` LIMIT {}", BENCH_TABLE_NAME, rows))
+            {
+                do
+                {
+                    auto fields = result->Fetch();
+                    _checksum += fields[0].Get<uint32>() + fields[1].Get<uint32>() + fields[2].Get<std::string_view>().size();
+                    ++decoded;
+                } while (result->NextRow());
+            }
+
+            latency.Add(GetElapsed(runBegin));
+        }
+
+        // Operations of the case are decoded rows
+        AddResult(fmt::format("resultset_{}_{}", prepared ? "prepared" : "adhoc", rows), 1, decoded, uint64(rows) * RESULT_SET_RUNS - decoded, GetElapsed(begin), latency);
+    }
+}
+
+std::string DatabaseBench::ToJson() const
+{
+    fmt::memory_buffer json;
+    auto out = std::back_inserter(json);
+
+    fmt::format_to(out, "{{\n  \"operations\": {},\n  \"results\": [\n", _operations);
+
+    for (std::size_t i = 0; i < _results.size(); ++i)
+    {
+        BenchResult const& result = _results[i];
+        double seconds = std::max<double>(result.Elapsed.count(), 1) / 1000000.0;
+
+        fmt::format_to(out, "    {{ \"case\": \"{}\", \"threads\": {}, \"operations\": {}, \"errors\": {}, \"deadlocks\": {}, \"elapsed_us\": {}, "
+            "\"ops_per_sec\": {:.1f}, \"p50_us\": {}, \"p99_us\": {}, \"max_us\": {} }}{}\n",
+            result.Case, result.Threads, result.Operations, result.Errors, result.Deadlocks, result.Elapsed.count(),
+            result.Operations / seconds, result.P50.count(), result.P99.count(), result.Max.count(), i + 1 < _results.size() ? "," : "");
+    }
+
+    fmt::format_to(out, "  ]\n}}\n");
+    return fmt::to_string(json);
+}
+
+void DatabaseBench::AddResult(std::string_view name, uint32 threads, uint64 operations, uint64 errors, Microseconds elapsed, LatencyHistogram const& latency)
+{
+    BenchResult& result = _results.emplace_back();
+    result.Case = name;
+    result.Threads = threads;
+    result.Operations = operations;
+    result.Errors = errors;
+    result.Elapsed = elapsed;
+    result.P50 = latency.GetPercentile(0.5);
+    result.P99 = latency.GetPercentile(0.99);
+    result.Max = latency.GetMax();
+
+    fmt::print(stderr, "> {:<28} threads {:>3}: {:>9} ops in {:>10} us, p50 {} us, p99 {} us, errors {}\n",
+        result.Case, threads, operations, elapsed.count(), result.P50.count(), result.P99.count(), errors);
+}
+
+uint64 DatabaseBench::GetRowCount()
+{
+    QueryResult result = _pool.Query("SELECT COUNT(*) FROM `{}`", BENCH_TABLE_NAME);
+    return result ? result->Fetch()[0].Get<uint64>() : 0;
+}
+
+uint64 DatabaseBench::GetDeadlockCount() const
+{
+    uint64 count{};
+
+    for (auto const& [table, deadlocks] : _pool.GetStatistics()->GetDeadlockInfo())
+        count += deadlocks;
+
+    return count;
+}
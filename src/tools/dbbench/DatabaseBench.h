@@ -0,0 +1,95 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DATABASE_BENCH_H_
+#define _DATABASE_BENCH_H_
+
+#include "Define.h"
+#include "Duration.h"
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class BenchDatabasePool;
+class LatencyHistogram;
+
+struct BenchResult
+{
+    std::string Case;
+    uint32 Threads{};
+    uint64 Operations{};
+    uint64 Errors{};
+    uint64 Deadlocks{};
+    Microseconds Elapsed{};
+    Microseconds P50{};
+    Microseconds P99{};
+    Microseconds Max{};
+};
+
+/**
+    Cases measuring the database layer against a live server.
+
+    Every case is run by producer threads issuing operations at once, latency of each operation
+    is recorded and the throughput is taken over the whole case, until the server executed every operation.
+*/
+class DatabaseBench
+{
+public:
+    DatabaseBench(BenchDatabasePool& pool, uint32 operations) : _pool(pool), _operations(operations) { }
+
+    //! Fills the scratch table with rows for the read cases
+    void Seed(uint32 rows);
+
+    //! One-way async writes (Execute)
+    void RunExecute(uint32 threads);
+
+    //! Async reads waited for through a callback processor per producer (AsyncQuery)
+    void RunAsyncQuery(uint32 threads);
+
+    //! Sync reads, producers contend for the sync connections (Query, GetFreeConnection)
+    void RunQuery(uint32 threads);
+
+    //! Async transactions of two updates on random rows
+    void RunTransaction(uint32 threads);
+
+    //! Async transactions updating the same two rows in opposite order, deadlocks are retried by the pool
+    void RunDeadlock(uint32 threads);
+
+    //! Fetch and decode of big results, ad hoc and prepared
+    void RunResultSet(uint32 rows);
+
+    [[nodiscard]] std::string ToJson() const;
+
+private:
+    //! Runs operation(thread, iteration) on the producers, returns false for a failed operation
+    template<typename Operation>
+    void RunProducers(std::string_view name, uint32 threads, Operation&& operation, std::function<void()> const& drain = {});
+
+    void AddResult(std::string_view name, uint32 threads, uint64 operations, uint64 errors, Microseconds elapsed, LatencyHistogram const& latency);
+
+    uint64 GetRowCount();
+    uint64 GetDeadlockCount() const;
+
+    BenchDatabasePool& _pool;
+    uint32 _operations;
+    uint32 _seededRows{};
+    uint64 _checksum{}; ///< Sum of decoded values, keeps the decoding from being optimized out
+    std::vector<BenchResult> _results;
+};
+
+#endif
@@ -0,0 +1,256 @@
+/*
+ * This file is part of the WarheadCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "BenchDatabase.h"
+#include "Config.h"
+#include "DatabaseBench.h"
+#include "DatabaseMgr.h"
+#include "Log.h"
+#include "StringConvert.h"
+#include "Tokenize.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <optional>
+
+namespace
+{
+    constexpr auto DEFAULT_THREADS = "1,2,4,8,16,32,64";
+    constexpr auto DEFAULT_ROWS = "1000,10000,100000,1000000";
+    constexpr auto DEFAULT_CASES = "execute,async_query,query,transaction,deadlock,resultset";
+    constexpr uint32 DEFAULT_OPERATIONS = 10000;
+
+    // Rows the read cases pick from
+    constexpr uint32 READ_SEED_ROWS = 10000;
+
+    struct BenchOptions
+    {
+        std::string Database;
+        std::string Config;
+        std::vector<uint32> Threads;
+        std::vector<uint32> Rows;
+        std::vector<std::string_view> Cases;
+        uint32 Operations{ DEFAULT_OPERATIONS };
+        std::string Output;
+        bool KeepTable{};
+    };
+
+    void PrintUsage()
+    {
+        fmt::print(stderr,
+            "Usage: dbbench --db \"host;port;user;password;database\" [options]\n"
+            "Runs the database layer benchmarks against a scratch table of a throwaway database.\n\n"
+            "  --db <info>          Connection info, same format as the Database.Info options\n"
+            "  --config <file>      Config of the pool options (Database.*), its .dist file must be next to it\n"
+            "  --threads <list>     Producer threads of every case, default {}\n"
+            "  --operations <n>     Operations of every case, default {}\n"
+            "  --rows <list>        Rows of the result set case, default {}\n"
+            "  --cases <list>       Cases to run, default {}\n"
+            "  --output <file>      Writes the JSON report to the file instead of stdout\n"
+            "  --keep               Doesn't drop the scratch table `{}` at the end\n",
+            DEFAULT_THREADS, DEFAULT_OPERATIONS, DEFAULT_ROWS, DEFAULT_CASES, BENCH_TABLE_NAME);
+    }
+
+    std::optional<std::vector<uint32>> ParseNumbers(std::string_view list)
+    {
+        std::vector<uint32> numbers;
+
+        for (std::string_view token : Warhead::Tokenize(list, ',', false))
+        {
+            auto number = Warhead::StringTo<uint32>(token);
+            if (!number || !*number)
+                return std::nullopt;
+
+            numbers.emplace_back(*number);
+        }
+
+        if (numbers.empty())
+            return std::nullopt;
+
+        return numbers;
+    }
+
+    std::optional<BenchOptions> ParseOptions(int argc, char** argv)
+    {
+        BenchOptions options;
+        std::string_view threads = DEFAULT_THREADS;
+        std::string_view rows = DEFAULT_ROWS;
+        std::string_view cases = DEFAULT_CASES;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg = argv[i];
+
+            if (arg == "--keep")
+            {
+                options.KeepTable = true;
+                continue;
+            }
+
+            if (i + 1 >= argc)
+            {
+                fmt::print(stderr, "> Missing value of option {}\n", arg);
+                return std::nullopt;
+            }
+
+            std::string_view value = argv[++i];
+
+            if (arg == "--db")
+                options.Database = value;
+            else if (arg == "--config")
+                options.Config = value;
+            else if (arg == "--threads")
+                threads = value;
+            else if (arg == "--rows")
+                rows = value;
+            else if (arg == "--cases")
+                cases = value;
+            else if (arg == "--output")
+                options.Output = value;
+            else if (arg == "--operations")
+            {
+                auto operations = Warhead::StringTo<uint32>(value);
+                if (!operations || !*operations)
+                {
+                    fmt::print(stderr, "> Incorrect number of operations '{}'\n", value);
+                    return std::nullopt;
+                }
+
+                options.Operations = *operations;
+            }
+            else
+            {
+                fmt::print(stderr, "> Unknown option {}\n", arg);
+                return std::nullopt;
+            }
+        }
+
+        if (options.Database.empty())
+            return std::nullopt;
+
+        auto threadList = ParseNumbers(threads);
+        auto rowList = ParseNumbers(rows);
+        if (!threadList || !rowList)
+        {
+            fmt::print(stderr, "> Incorrect list of threads or rows\n");
+            return std::nullopt;
+        }
+
+        options.Threads = std::move(*threadList);
+        options.Rows = std::move(*rowList);
+        options.Cases = Warhead::Tokenize(cases, ',', false);
+        return options;
+    }
+
+    bool HasCase(BenchOptions const& options, std::string_view name)
+    {
+        return std::find(options.Cases.begin(), options.Cases.end(), name) != options.Cases.end();
+    }
+}
+
+/// Launch the benchmark
+int main(int argc, char** argv)
+{
+    auto options = ParseOptions(argc, argv);
+    if (!options)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    // Without config the pool uses the defaults of every option
+    if (!options->Config.empty())
+    {
+        sConfigMgr->Configure(options->Config);
+        if (!sConfigMgr->LoadAppConfigs())
+            return 1;
+
+        sLog->Initialize();
+    }
+
+    // Initializes the client library
+    fmt::print(stderr, "> Using DB client version: {}\n", sDatabaseMgr->GetClientInfo());
+
+    BenchDatabasePool pool;
+    pool.SetPoolName("Bench");
+    pool.SetConnectionInfo(options->Database);
+
+    if (pool.Open())
+    {
+        fmt::print(stderr, "> Failed to connect to the database\n");
+        return 1;
+    }
+
+    if (!pool.CreateTable() || !pool.PrepareStatements())
+    {
+        fmt::print(stderr, "> Failed to prepare table `{}`\n", BENCH_TABLE_NAME);
+        pool.Close();
+        return 1;
+    }
+
+    DatabaseBench bench(pool, options->Operations);
+    bench.Seed(READ_SEED_ROWS);
+
+    for (uint32 threads : options->Threads)
+    {
+        if (HasCase(*options, "execute"))
+            bench.RunExecute(threads);
+
+        if (HasCase(*options, "async_query"))
+            bench.RunAsyncQuery(threads);
+
+        if (HasCase(*options, "query"))
+            bench.RunQuery(threads);
+
+        if (HasCase(*options, "transaction"))
+            bench.RunTransaction(threads);
+
+        // One producer can't deadlock
+        if (HasCase(*options, "deadlock") && threads > 1)
+            bench.RunDeadlock(threads);
+    }
+
+    if (HasCase(*options, "resultset"))
+        for (uint32 rows : options->Rows)
+            bench.RunResultSet(rows);
+
+    if (!options->KeepTable)
+        pool.DropTable();
+
+    pool.Close();
+
+    std::string json = bench.ToJson();
+
+    if (options->Output.empty())
+        std::cout << json;
+    else
+    {
+        std::ofstream output(options->Output);
+        if (!output)
+        {
+            fmt::print(stderr, "> Failed to open {}\n", options->Output);
+            return 1;
+        }
+
+        output << json;
+    }
+
+    return 0;
+}